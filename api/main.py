@@ -1,9 +1,10 @@
 from fastapi import FastAPI, UploadFile, File, HTTPException
-from fastapi.responses import FileResponse
+from fastapi.responses import PlainTextResponse
 from fastapi.middleware.cors import CORSMiddleware
-import subprocess
+import asyncio
+import base64
 import os
-import shutil
+import struct
 
 app = FastAPI(title="OCR Sudoku API")
 
@@ -16,65 +17,93 @@ app.add_middleware(
     allow_headers=["*"],
 )
 
-UPLOAD_DIR = "data"
-OUTPUT_IMAGE = "output_api.png"
-DEBUG_IMAGES = [
-    "debug_1_gray.png",
-    "debug_2_blurred.png",
-    "debug_3_binary.png",
-    "debug_4_grid_detected.png",
-    "debug_5_rectified.png",
-    "debug_6_cells.png"
-]
+# Socket of the solver daemon (./build/sudoku_daemon <socket> [weights])
+SOLVER_SOCKET = os.environ.get("SOLVER_SOCKET", "/tmp/sudoku_solver.sock")
+SOLVER_TIMEOUT = 30.0
+
+# Framed protocol, little-endian u32 (see src/solver_daemon.c)
+REQUEST_MAGIC = 0x514B4453   # "SDKQ"
+RESPONSE_MAGIC = 0x524B4453  # "SDKR"
+FLAG_WANT_PNG = 0x1
+FLAG_METRICS = 0x2
+STATUS_MESSAGES = {
+    1: (400, "Invalid image"),
+    2: (422, "Failed to detect grid"),
+    3: (422, "Failed to extract cells"),
+    4: (500, "CNN inference failed"),
+    5: (422, "Could not find a valid grid configuration"),
+    6: (500, "Solver out of memory"),
+    100: (400, "Request rejected by solver"),
+    101: (503, "Solver overloaded, retry later"),
+}
+
+async def solve_with_daemon(image_bytes: bytes, flags: int = FLAG_WANT_PNG):
+    """Sends one image to the solver daemon and returns (status, clues, solution, png)."""
+    reader, writer = await asyncio.open_unix_connection(SOLVER_SOCKET)
+    try:
+        writer.write(struct.pack("<III", REQUEST_MAGIC, flags, len(image_bytes)))
+        writer.write(image_bytes)
+        try:
+            await writer.drain()
+        except (ConnectionResetError, BrokenPipeError):
+            # A request rejected from its header alone is answered and closed
+            # without reading the upload: the response is still waiting in
+            # the socket buffer
+            pass
+
+        magic, status, png_size = struct.unpack("<III", await reader.readexactly(12))
+        if magic != RESPONSE_MAGIC:
+            raise RuntimeError("Invalid response from solver daemon")
+        grids = await reader.readexactly(162)
+        png = await reader.readexactly(png_size) if png_size else b""
+        return status, list(grids[:81]), list(grids[81:]), png
+    finally:
+        writer.close()
+        await writer.wait_closed()
+
+
+def to_rows(cells):
+    return [cells[r * 9:(r + 1) * 9] for r in range(9)]
+
 
 @app.post("/solve")
 async def solve_sudoku(file: UploadFile = File(...)):
-    # Ensure data directory exists
-    os.makedirs(UPLOAD_DIR, exist_ok=True)
-    
-    file_location = os.path.join(UPLOAD_DIR, "api_upload.png")
-    
-    # Save uploaded file
-    with open(file_location, "wb") as buffer:
-        shutil.copyfileobj(file.file, buffer)
-        
-    # Run C program
-    # Assuming running from root: ./build/sudoku_solver
-    # Usage: ./build/sudoku_solver <input_image> <output_image>
-    command = ["./build/sudoku_solver", file_location, OUTPUT_IMAGE]
-    
+    image_bytes = await file.read()
+    if not image_bytes:
+        raise HTTPException(status_code=400, detail="Empty upload")
+
     try:
-        # Run with timeout to prevent infinite loops if they still exist
-        result = subprocess.run(command, capture_output=True, text=True, timeout=30)
-        
-        if result.returncode != 0:
-             raise HTTPException(status_code=500, detail=f"Solver failed: {result.stderr}")
-             
-        return {
-            "message": "Sudoku processed successfully",
-            "stdout": result.stdout,
-            "stderr": result.stderr
-        }
-    except subprocess.TimeoutExpired:
+        status, clues, solution, png = await asyncio.wait_for(
+            solve_with_daemon(image_bytes), timeout=SOLVER_TIMEOUT)
+    except asyncio.TimeoutError:
         raise HTTPException(status_code=504, detail="Solver timed out")
-    except Exception as e:
-        raise HTTPException(status_code=500, detail=f"Error running solver: {str(e)}")
+    except (ConnectionError, FileNotFoundError, asyncio.IncompleteReadError) as e:
+        raise HTTPException(status_code=503, detail=f"Solver daemon unavailable: {e}")
+
+    if status != 0:
+        code, message = STATUS_MESSAGES.get(status, (500, f"Solver error {status}"))
+        raise HTTPException(status_code=code, detail=message)
 
-@app.get("/debug-images")
-def list_debug_images():
-    # Check which exist
-    existing = [img for img in DEBUG_IMAGES if os.path.exists(img)]
-    return {"images": existing}
+    # The solved image travels with its own response: nothing is shared
+    # between concurrent requests
+    return {
+        "message": "Sudoku processed successfully",
+        "grid": to_rows(clues),
+        "solution": to_rows(solution),
+        "image_png": base64.b64encode(png).decode() if png else None,
+    }
+
+@app.get("/metrics", response_class=PlainTextResponse)
+async def metrics():
+    """Per-stage timings and counters of the solver daemon (Prometheus text)."""
+    try:
+        status, _, _, payload = await asyncio.wait_for(
+            solve_with_daemon(b"", FLAG_METRICS), timeout=SOLVER_TIMEOUT)
+    except (asyncio.TimeoutError, ConnectionError, FileNotFoundError,
+            asyncio.IncompleteReadError) as e:
+        raise HTTPException(status_code=503, detail=f"Solver daemon unavailable: {e}")
 
-@app.get("/debug-images/{image_name}")
-def get_debug_image(image_name: str):
-    # Allow getting debug images and the output image
-    allowed = DEBUG_IMAGES + [OUTPUT_IMAGE]
-    
-    if image_name not in allowed:
-        raise HTTPException(status_code=404, detail="Image not found or not allowed")
-    
-    if not os.path.exists(image_name):
-        raise HTTPException(status_code=404, detail="Image file does not exist")
-        
-    return FileResponse(image_name)
+    if status != 0:
+        code, message = STATUS_MESSAGES.get(status, (500, f"Solver error {status}"))
+        raise HTTPException(status_code=code, detail=message)
+    return PlainTextResponse(payload.decode(), media_type="text/plain; version=0.0.4")
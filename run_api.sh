@@ -8,5 +8,26 @@ source venv/bin/activate
 echo "Installing dependencies..."
 pip install -r api/requirements.txt
 
+# The API forwards uploads to the solver daemon over a Unix socket
+export SOLVER_SOCKET="${SOLVER_SOCKET:-/tmp/sudoku_solver.sock}"
+if [ ! -x "build/sudoku_daemon" ]; then
+    echo "Building solver daemon..."
+    make daemon || exit 1
+fi
+
+echo "Starting solver daemon on $SOLVER_SOCKET..."
+./build/sudoku_daemon "$SOLVER_SOCKET" models/cnn_weights.bin &
+DAEMON_PID=$!
+trap 'kill $DAEMON_PID 2>/dev/null; wait $DAEMON_PID 2>/dev/null' EXIT
+
+for _ in $(seq 50); do
+    [ -S "$SOLVER_SOCKET" ] && break
+    if ! kill -0 $DAEMON_PID 2>/dev/null; then
+        echo "Solver daemon failed to start"
+        exit 1
+    fi
+    sleep 0.1
+done
+
 echo "Starting API..."
 uvicorn api.main:app --reload --host 0.0.0.0 --port 8000
@@ -0,0 +1,264 @@
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/resource.h>
+#include "utils.h"
+#include "image_loader.h"
+#include "cnn_model.h"
+#include "simd_kernels.h"
+#include "sudoku_pipeline.h"
+#include "sudoku_solver.h"
+#include "trace.h"
+
+// ============================================================================
+// BENCHMARK DU PIPELINE COMPLET
+// ============================================================================
+//
+// Exécute le pipeline (chargement + sudoku_pipeline_run, comme sudoku_solver)
+// sur toutes les images d'un dossier: `warmup` passes non mesurées puis
+// `iterations` passes mesurées. Les durées par étape viennent des traces
+// (différence des agrégats avant/après chaque image). Les résultats sont
+// écrits en JSON, une valeur par ligne et dans un ordre fixe, pour pouvoir
+// comparer deux commits avec diff.
+
+#define MAX_BENCH_IMAGES 1024
+
+static double wall_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static bool has_image_extension(const char *name) {
+    const char *dot = strrchr(name, '.');
+    if (!dot) return false;
+    return strcasecmp(dot, ".png") == 0 || strcasecmp(dot, ".jpg") == 0 ||
+           strcasecmp(dot, ".jpeg") == 0 || strcasecmp(dot, ".bmp") == 0;
+}
+
+static int compare_strings(const void *a, const void *b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double diff = *(const double*)a - *(const double*)b;
+    if (diff > 0) return 1;
+    if (diff < 0) return -1;
+    return 0;
+}
+
+// Liste les images du dossier, triées par nom (ordre reproductible)
+// Returns: nombre d'images, paths alloués (à libérer)
+static int list_images(const char *dir_path, char **paths) {
+    DIR *dir = opendir(dir_path);
+    if (!dir) {
+        LOG_ERROR("Impossible d'ouvrir le dossier %s", dir_path);
+        return 0;
+    }
+
+    int count = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL && count < MAX_BENCH_IMAGES) {
+        if (!has_image_extension(entry->d_name)) continue;
+
+        size_t len = strlen(dir_path) + strlen(entry->d_name) + 2;
+        paths[count] = (char*)malloc(len);
+        if (!paths[count]) break;
+        snprintf(paths[count], len, "%s/%s", dir_path, entry->d_name);
+        count++;
+    }
+    closedir(dir);
+
+    qsort(paths, count, sizeof(char*), compare_strings);
+    return count;
+}
+
+// Percentile par rang le plus proche sur des valeurs triées
+static double percentile(const double *sorted, int n, double p) {
+    if (n == 0) return 0.0;
+    int rank = (int)(p / 100.0 * n + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+    return sorted[rank - 1];
+}
+
+typedef struct {
+    double p50, p95, p99, mean, max;
+} LatencySummary;
+
+static LatencySummary summarize(double *samples, int n) {
+    LatencySummary s = {0, 0, 0, 0, 0};
+    if (n == 0) return s;
+
+    qsort(samples, n, sizeof(double), compare_doubles);
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += samples[i];
+
+    s.p50 = percentile(samples, n, 50.0);
+    s.p95 = percentile(samples, n, 95.0);
+    s.p99 = percentile(samples, n, 99.0);
+    s.mean = sum / n;
+    s.max = samples[n - 1];
+    return s;
+}
+
+static long peak_rss_kb(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;  // Kio sous Linux
+}
+
+// Charge puis résout une image. Returns: statut du pipeline
+static PipelineStatus run_once(const CNNModel *model, InferenceContext *ctx, const char *path) {
+    uint64_t t = trace_begin();
+    RGBImage *image = load_rgb_image(path);
+    trace_end(TRACE_LOAD, t);
+    if (!image) return PIPELINE_ERR_IMAGE;
+
+    PipelineOptions options = pipeline_default_options();
+    PipelineResult result;
+    PipelineStatus status = sudoku_pipeline_run(model, ctx, image, &options, &result);
+    rgb_image_free(image);
+    if (status == PIPELINE_OK) pipeline_result_free(&result);
+    return status;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <image_dir> [iterations] [warmup] [results.json] [weights_path]\n", argv[0]);
+        fprintf(stderr, "Exemple: %s data/test_images 10 2 build/bench_results.json\n", argv[0]);
+        return 1;
+    }
+
+    // CNN_CONV_ALGO, CNN_SIMD et SUDOKU_ENGINE pour comparer les moteurs
+    if (!pipeline_configure_engines_from_env()) return 1;
+    const char *conv_algo = (cnn_get_conv_algorithm() == CONV_ALGO_DIRECT) ? "direct" : "im2col";
+
+    const char *image_dir = argv[1];
+    int iterations = (argc > 2) ? atoi(argv[2]) : 5;
+    int warmup = (argc > 3) ? atoi(argv[3]) : 1;
+    const char *results_path = (argc > 4) ? argv[4] : "build/bench_results.json";
+    const char *weights_path = (argc > 5) ? argv[5] : "models/cnn_weights.bin";
+    if (iterations < 1) iterations = 1;
+    if (warmup < 0) warmup = 0;
+
+    char *paths[MAX_BENCH_IMAGES];
+    int num_images = list_images(image_dir, paths);
+    if (num_images == 0) {
+        LOG_ERROR("Aucune image (.png/.jpg/.jpeg/.bmp) dans %s", image_dir);
+        return 1;
+    }
+
+    CNNModel *model = map_cnn_model(weights_path);
+    if (!model) {
+        model = create_cnn_model();
+        if (!load_cnn_weights(model, weights_path)) {
+            LOG_ERROR("Poids introuvables, poids aléatoires (tests uniquement)");
+        }
+    }
+
+    // Contexte réutilisé comme dans un worker du démon (régime permanent)
+    InferenceContext *ctx = create_inference_context(model, 81);
+    int total_runs = num_images * iterations;
+    double *stage_samples = (double*)malloc((size_t)TRACE_STAGE_COUNT * total_runs * sizeof(double));
+    if (!ctx || !stage_samples) {
+        LOG_ERROR("Allocation impossible");
+        free(stage_samples);
+        free_inference_context(ctx);
+        free_cnn_model(model);
+        for (int i = 0; i < num_images; i++) free(paths[i]);
+        return 1;
+    }
+
+    printf("Benchmark: %d images, %d passes de chauffe, %d passes mesurées (convolution %s, noyaux %s, moteur %s)\n",
+           num_images, warmup, iterations, conv_algo, simd_kernels()->name,
+           sudoku_engine_name(sudoku_get_engine()));
+
+    for (int w = 0; w < warmup; w++) {
+        for (int i = 0; i < num_images; i++) run_once(model, ctx, paths[i]);
+    }
+
+    // Compteurs et durées limités aux passes mesurées
+    trace_reset();
+
+    int failures = 0;
+    int run = 0;
+    double start = wall_ms();
+    for (int it = 0; it < iterations; it++) {
+        for (int i = 0; i < num_images; i++, run++) {
+            TraceSnapshot before, after;
+            trace_snapshot(&before);
+            if (run_once(model, ctx, paths[i]) != PIPELINE_OK) failures++;
+            trace_snapshot(&after);
+
+            for (int s = 0; s < TRACE_STAGE_COUNT; s++) {
+                uint64_t ns = after.stages[s].total_ns - before.stages[s].total_ns;
+                stage_samples[s * total_runs + run] = ns / 1e6;
+            }
+        }
+    }
+    double elapsed_ms = wall_ms() - start;
+    double throughput = total_runs / (elapsed_ms / 1000.0);
+    long rss_kb = peak_rss_kb();
+
+    TraceSnapshot totals;
+    trace_snapshot(&totals);
+
+    LatencySummary summaries[TRACE_STAGE_COUNT];
+    for (int s = 0; s < TRACE_STAGE_COUNT; s++) {
+        summaries[s] = summarize(stage_samples + s * total_runs, total_runs);
+    }
+
+    // Rapport lisible
+    printf("\n%-14s %10s %10s %10s %10s\n", "Étape (ms)", "p50", "p95", "p99", "max");
+    for (int s = 0; s < TRACE_STAGE_COUNT; s++) {
+        printf("%-14s %10.3f %10.3f %10.3f %10.3f\n", trace_stage_name(s),
+               summaries[s].p50, summaries[s].p95, summaries[s].p99, summaries[s].max);
+    }
+    printf("\nDébit: %.2f images/s (%d exécutions, %d échecs)\n", throughput, total_runs, failures);
+    printf("RSS max: %ld Kio\n", rss_kb);
+
+    // Résultats JSON
+    FILE *out = fopen(results_path, "w");
+    if (!out) {
+        LOG_ERROR("Impossible d'écrire %s", results_path);
+    } else {
+        fprintf(out, "{\n");
+        fprintf(out, "  \"images\": %d,\n", num_images);
+        fprintf(out, "  \"warmup\": %d,\n", warmup);
+        fprintf(out, "  \"iterations\": %d,\n", iterations);
+        fprintf(out, "  \"conv_algo\": \"%s\",\n", conv_algo);
+        fprintf(out, "  \"kernels\": \"%s\",\n", simd_kernels()->name);
+        fprintf(out, "  \"solver_engine\": \"%s\",\n", sudoku_engine_name(sudoku_get_engine()));
+        fprintf(out, "  \"runs\": %d,\n", total_runs);
+        fprintf(out, "  \"failures\": %d,\n", failures);
+        fprintf(out, "  \"throughput_images_per_sec\": %.3f,\n", throughput);
+        fprintf(out, "  \"peak_rss_kb\": %ld,\n", rss_kb);
+        fprintf(out, "  \"stages_ms\": {\n");
+        for (int s = 0; s < TRACE_STAGE_COUNT; s++) {
+            fprintf(out, "    \"%s\": {\"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"mean\": %.3f, \"max\": %.3f}%s\n",
+                    trace_stage_name(s), summaries[s].p50, summaries[s].p95, summaries[s].p99,
+                    summaries[s].mean, summaries[s].max, (s + 1 < TRACE_STAGE_COUNT) ? "," : "");
+        }
+        fprintf(out, "  },\n");
+        fprintf(out, "  \"counters\": {\n");
+        for (int c = 0; c < TRACE_COUNTER_COUNT; c++) {
+            fprintf(out, "    \"%s\": %llu%s\n", trace_counter_name(c),
+                    (unsigned long long)totals.counters[c], (c + 1 < TRACE_COUNTER_COUNT) ? "," : "");
+        }
+        fprintf(out, "  }\n}\n");
+        fclose(out);
+        printf("Résultats: %s\n", results_path);
+    }
+
+    free(stage_samples);
+    free_inference_context(ctx);
+    free_cnn_model(model);
+    for (int i = 0; i < num_images; i++) free(paths[i]);
+    return failures == total_runs ? 1 : 0;
+}
@@ -0,0 +1,99 @@
+#include "cell_cleanup.h"
+#include <string.h>
+
+// En 4-connexité, une nouvelle étiquette exige un voisin gauche et un voisin
+// haut de fond: au plus une étiquette pour deux pixels (damier)
+#define CELL_MAX_LABELS (CELL_CLEANUP_MAX_PIXELS / 2 + 2)
+#define NO_SEED         0xFFFF
+
+static int find_label(uint16_t *parent, int label) {
+    while (parent[label] != label) {
+        parent[label] = parent[parent[label]];  // Compression par moitié
+        label = parent[label];
+    }
+    return label;
+}
+
+// La racine la plus récente pointe vers la plus ancienne: parent[l] <= l
+static void union_labels(uint16_t *parent, int a, int b) {
+    a = find_label(parent, a);
+    b = find_label(parent, b);
+    if (a < b) parent[b] = (uint16_t)a;
+    else if (b < a) parent[a] = (uint16_t)b;
+}
+
+bool cell_cleanup(uint8_t *pixels, int width, int height) {
+    if (width <= 0 || height <= 0) return true;
+    if (width * height > CELL_CLEANUP_MAX_PIXELS) return false;
+
+    uint16_t labels[CELL_CLEANUP_MAX_PIXELS];   // Étiquette provisoire, 0 = fond
+    uint16_t parent[CELL_MAX_LABELS];
+    uint16_t area[CELL_MAX_LABELS];
+    uint16_t seed[CELL_MAX_LABELS];             // Premier pixel > 128, ou NO_SEED
+    int next = 1;
+    parent[0] = 0;
+
+    // Passe unique: étiquette du voisin gauche ou haut (union si les deux),
+    // aire et premier pixel > 128 cumulés par étiquette provisoire
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            int i = y * width + x;
+            if (pixels[i] < 128) {
+                labels[i] = 0;
+                continue;
+            }
+            int left = (x > 0) ? labels[i - 1] : 0;
+            int up = (y > 0) ? labels[i - width] : 0;
+            int label;
+            if (left) {
+                label = left;
+                if (up && up != left) union_labels(parent, left, up);
+            } else if (up) {
+                label = up;
+            } else {
+                label = next++;
+                parent[label] = (uint16_t)label;
+                area[label] = 0;
+                seed[label] = NO_SEED;
+            }
+            labels[i] = (uint16_t)label;
+            area[label]++;
+            if (pixels[i] > 128 && seed[label] == NO_SEED) seed[label] = (uint16_t)i;
+        }
+    }
+
+    // Étiquettes ramenées à leur racine (parent[l] < l déjà résolu), cumuls
+    // reportés sur la racine
+    for (int l = 1; l < next; l++) {
+        int root = parent[parent[l]];
+        parent[l] = (uint16_t)root;
+        if (root == l) continue;
+        area[root] += area[l];
+        if (seed[l] < seed[root]) seed[root] = seed[l];
+    }
+
+    int best = 0;
+    for (int l = 1; l < next; l++) {
+        if (parent[l] != l || seed[l] == NO_SEED) continue;
+        if (!best || area[l] > area[best] || (area[l] == area[best] && seed[l] < seed[best])) {
+            best = l;
+        }
+    }
+
+    if (!best) {
+        memset(pixels, 0, (size_t)width * height);
+        return true;
+    }
+    for (int i = 0; i < width * height; i++) {
+        if (parent[labels[i]] != best) pixels[i] = 0;
+    }
+    return true;
+}
+
+bool cell_cleanup_batch(uint8_t *pixels, int count, int width, int height) {
+    if (width * height > CELL_CLEANUP_MAX_PIXELS) return false;
+    for (int c = 0; c < count; c++) {
+        cell_cleanup(pixels + (size_t)c * width * height, width, height);
+    }
+    return true;
+}
@@ -0,0 +1,31 @@
+#ifndef CELL_CLEANUP_H
+#define CELL_CLEANUP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// NETTOYAGE DES CASES
+// ============================================================================
+//
+// Ne garde que la plus grande composante connexe d'une case (chiffre blanc sur
+// fond noir): les restes de lignes de grille sont effacés. Étiquetage
+// union-find en une passe linéaire sur des tampons de taille fixe (pile),
+// sans allocation.
+// Avant-plan: pixels >= 128, 4-connexité. Seules les composantes contenant un
+// pixel > 128 sont candidates; à aire égale, celle dont le premier pixel > 128
+// vient en premier dans l'ordre de balayage est gardée. Les pixels gardés
+// conservent leur valeur, les autres passent à 0; sans candidate, la case est
+// effacée.
+
+#define CELL_CLEANUP_MAX_PIXELS (64 * 64)   // Taille de case maximale
+
+// Nettoie une case de width x height pixels en place
+// Returns: false si la case dépasse CELL_CLEANUP_MAX_PIXELS (inchangée)
+bool cell_cleanup(uint8_t *pixels, int width, int height);
+
+// Nettoie count cases de width x height pixels rangées bout à bout
+// Returns: false si les cases dépassent CELL_CLEANUP_MAX_PIXELS (inchangées)
+bool cell_cleanup_batch(uint8_t *pixels, int count, int width, int height);
+
+#endif // CELL_CLEANUP_H
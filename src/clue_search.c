@@ -0,0 +1,132 @@
+#include "clue_search.h"
+#include "sudoku_bitmask.h"
+#include "sudoku_solver.h"
+#include "trace.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_PROB 1e-30f             // Évite log(0)
+
+// État d'une recherche (un appel)
+typedef struct {
+    const ClueCell *cells;
+    int order[81];                          // Cases non vides, plus sûre d'abord
+    int num_clues;
+    double cost[81][CLUE_MAX_CANDIDATES];   // -log p par case et candidat
+    int tries[81];                          // Candidats considérés par case
+    uint8_t clues[81];                      // Affectation en cours
+    double best_cost;                       // Coût de la meilleure trouvée
+    bool found;
+    ClueSearchResult *result;
+} ClueSearch;
+
+static int compare_clue_candidates(const void *a, const void *b) {
+    float diff = ((const ClueCandidate*)b)->prob - ((const ClueCandidate*)a)->prob;
+    if (diff > 0) return 1;
+    if (diff < 0) return -1;
+    return 0;
+}
+
+void clue_cell_sort(ClueCell *cell) {
+    qsort(cell->candidates, cell->count, sizeof(ClueCandidate), compare_clue_candidates);
+}
+
+// Minorant du coût des cases depth..num_clues-1: meilleur candidat encore
+// permis de chacune
+// Returns: INFINITY si une case n'a plus aucun candidat permis
+static double remaining_bound(const ClueSearch *cs, const BitmaskSolver *state, int depth) {
+    double bound = 0.0;
+    for (int d = depth; d < cs->num_clues; d++) {
+        int cell = cs->order[d];
+        int i = 0;
+        while (i < cs->tries[cell] &&
+               !bitmask_solver_allows(state, cell, cs->cells[cell].candidates[i].digit)) {
+            i++;
+        }
+        if (i == cs->tries[cell]) return INFINITY;
+        bound += cs->cost[cell][i];  // Candidats triés: le premier permis est le moins cher
+    }
+    return bound;
+}
+
+static void search(ClueSearch *cs, const BitmaskSolver *state, int depth, double g) {
+    ClueSearchResult *result = cs->result;
+    if (result->nodes >= CLUE_SEARCH_MAX_NODES) {
+        result->optimal = false;
+        return;
+    }
+    result->nodes++;
+
+    if (depth == cs->num_clues) {
+        // Affectation complète et cohérente, plus probable que la meilleure:
+        // le moteur courant repart de sa grille propagée
+        result->solver_calls++;
+        uint8_t grid[81];
+        uint64_t steps = 0;
+        int count = sudoku_count_cells(state->cells, 1, grid, &steps);
+        trace_count(TRACE_SOLVER_STEPS, steps);
+        if (count == 1) {
+            memcpy(result->clues, cs->clues, 81);
+            memcpy(result->solution, grid, 81);
+            result->log_prob = -g;
+            cs->best_cost = g;
+            cs->found = true;
+        }
+        return;
+    }
+
+    // À coût égal, la première affectation trouvée est gardée
+    if (g + remaining_bound(cs, state, depth) >= cs->best_cost) return;
+
+    int cell = cs->order[depth];
+    for (int i = 0; i < cs->tries[cell]; i++) {
+        int digit = cs->cells[cell].candidates[i].digit;
+        double child_g = g + cs->cost[cell][i];
+        if (child_g >= cs->best_cost) break;  // Candidats suivants plus chers
+
+        BitmaskSolver child = *state;
+        if (!bitmask_solver_place(&child, cell, digit) || !bitmask_solver_propagate(&child)) continue;
+
+        cs->clues[cell] = (uint8_t)digit;
+        search(cs, &child, depth + 1, child_g);
+        cs->clues[cell] = 0;
+    }
+}
+
+bool clue_search_run(const ClueCell cells[81], ClueSearchResult *result) {
+    memset(result, 0, sizeof(ClueSearchResult));
+    result->optimal = true;
+
+    ClueSearch cs;
+    memset(&cs, 0, sizeof(cs));
+    cs.cells = cells;
+    cs.best_cost = INFINITY;
+    cs.result = result;
+
+    // Cases non vides, de la plus sûre à la moins sûre (tri par insertion
+    // stable: à confiance égale, ordre des cases)
+    for (int i = 0; i < 81; i++) {
+        if (cells[i].count == 0) continue;
+        float prob = cells[i].candidates[0].prob;
+        int k = cs.num_clues++;
+        while (k > 0 && cells[cs.order[k - 1]].candidates[0].prob < prob) {
+            cs.order[k] = cs.order[k - 1];
+            k--;
+        }
+        cs.order[k] = i;
+
+        cs.tries[i] = cells[i].count < CLUE_MAX_CANDIDATES ? cells[i].count : CLUE_MAX_CANDIDATES;
+        for (int c = 0; c < cs.tries[i]; c++) {
+            float p = cells[i].candidates[c].prob;
+            cs.cost[i][c] = -log(p > MIN_PROB ? p : MIN_PROB);
+        }
+    }
+
+    BitmaskSolver root;
+    bitmask_solver_init(&root, cs.clues);
+    search(&cs, &root, 0, 0.0);
+
+    if (!cs.found) result->optimal = false;
+    return cs.found;
+}
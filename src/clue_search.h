@@ -0,0 +1,65 @@
+#ifndef CLUE_SEARCH_H
+#define CLUE_SEARCH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// CORRECTION DES INDICES PAR CSP PONDÉRÉ
+// ============================================================================
+//
+// Choisit un chiffre pour chaque case non vide à partir des probabilités du
+// CNN, de sorte que les indices soient cohérents et la grille soluble, en
+// maximisant la log-probabilité jointe sum(log p), soit en minimisant le coût
+// sum(-log p). Recherche en profondeur par séparation et évaluation (branch
+// and bound): cases prises de la plus sûre à la moins sûre, candidats du plus
+// probable au moins probable, donc la première affectation trouvée est celle
+// de l'ancien backtracking; la recherche continue ensuite avec la meilleure
+// comme borne.
+// Élagage, incrémental d'un nœud à l'autre (état du solveur à masques de bits
+// copié puis complété d'un indice):
+// - cohérence ligne/colonne/bloc du candidat;
+// - propagation des singletons: une contradiction prouve le sous-arbre
+//   insoluble;
+// - forward checking: chaque case restante doit garder un candidat permis, et
+//   la somme de leurs meilleurs coûts permis (minorant) doit rester sous le
+//   coût de la meilleure affectation trouvée.
+// Seules les affectations complètes sont résolues jusqu'au bout, par le
+// moteur courant (SUDOKU_ENGINE) à partir de leur grille propagée. Le nombre de
+// nœuds est borné: sur une grille ambiguë, la meilleure affectation trouvée
+// dans la limite est rendue, en temps borné.
+
+#define CLUE_MAX_CANDIDATES    5        // Candidats gardés par case (les plus probables)
+#define CLUE_SEARCH_MAX_NODES  20000    // Nœuds visités au plus
+
+typedef struct {
+    int digit;                  // 1-9
+    float prob;
+} ClueCandidate;
+
+typedef struct {
+    ClueCandidate candidates[9];    // Triés par probabilité décroissante
+    int count;                      // 0 = case vide
+} ClueCell;
+
+typedef struct {
+    uint8_t clues[81];          // Indices retenus, 0 = case vide
+    uint8_t solution[81];       // Grille résolue
+    double log_prob;            // Log-probabilité jointe des indices
+    bool optimal;               // Recherche terminée dans la limite: aucune
+                                // affectation soluble plus probable
+    int nodes;                  // Nœuds visités
+    int solver_calls;           // Affectations complètes passées au solveur
+} ClueSearchResult;
+
+// Trie les candidats d'une case par probabilité décroissante
+void clue_cell_sort(ClueCell *cell);
+
+// Cherche l'affectation d'indices soluble la plus probable
+// result: rempli dans tous les cas (nodes, solver_calls), clues, solution et
+//         log_prob seulement en cas de succès
+// Returns: false si aucune affectation soluble n'a été trouvée dans la limite
+//          de CLUE_SEARCH_MAX_NODES nœuds
+bool clue_search_run(const ClueCell cells[81], ClueSearchResult *result);
+
+#endif // CLUE_SEARCH_H
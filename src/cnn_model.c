@@ -1,8 +1,15 @@
+#define _POSIX_C_SOURCE 200809L  // mmap, fstat
+
 #include "cnn_model.h"
+#include "simd_kernels.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // ============================================================================
 // CRÉATION DES COUCHES
@@ -99,6 +106,8 @@ CNNModel* create_cnn_model() {
     model->pool2 = create_pool_layer(2, 16, 8, 8);          // -> 4x4x16 = 256
     model->fc1 = create_dense_layer(256, 120);              // -> 120
     model->fc2 = create_dense_layer(120, 10);               // -> 10 (classes)
+    model->mapping = NULL;
+    model->mapping_size = 0;
     
     LOG_INFO("Modèle CNN créé: Conv(6,5x5)->Pool(2x2)->Conv(16,5x5)->Pool(2x2)->FC(120)->FC(10)");
     return model;
@@ -139,6 +148,18 @@ void free_dense_layer(DenseLayer *layer) {
 
 void free_cnn_model(CNNModel *model) {
     if (!model) return;
+
+    // Poids projetés: ils appartiennent au fichier, pas au tas
+    if (model->mapping) {
+        ConvLayer *convs[2] = {model->conv1, model->conv2};
+        DenseLayer *denses[2] = {model->fc1, model->fc2};
+        for (int i = 0; i < 2; i++) {
+            if (convs[i]) convs[i]->weights = convs[i]->biases = NULL;
+            if (denses[i]) denses[i]->weights = denses[i]->biases = NULL;
+        }
+        munmap(model->mapping, model->mapping_size);
+    }
+
     free_conv_layer(model->conv1);
     free_pool_layer(model->pool1);
     free_conv_layer(model->conv2);
@@ -152,43 +173,121 @@ void free_cnn_model(CNNModel *model) {
 // FORWARD PASS - CONVOLUTION
 // ============================================================================
 
-float* conv_forward(ConvLayer *layer, const float *input) {
-    // Sauvegarder l'entrée pour la backprop
-    int input_size = layer->input_channels * layer->input_width * layer->input_height;
-    memcpy(layer->input_cache, input, input_size * sizeof(float));
-    
+static ConvAlgorithm conv_algorithm = CONV_ALGO_IM2COL;
+
+void cnn_set_conv_algorithm(ConvAlgorithm algo) {
+    conv_algorithm = algo;
+}
+
+ConvAlgorithm cnn_get_conv_algorithm(void) {
+    return conv_algorithm;
+}
+
+// Taille (en floats) de la matrice im2col d'une couche: (C*K*K) x (OH*OW)
+static int conv_im2col_size(const ConvLayer *layer) {
+    return layer->input_channels * layer->filter_size * layer->filter_size *
+           layer->output_width * layer->output_height;
+}
+
+// Déplie l'entrée pour que la convolution devienne W (F x CKK) * cols (CKK x P)
+// Ligne (c, fy, fx) de cols = plan c décalé de (fy, fx), lu ligne par ligne
+static void im2col(const ConvLayer *layer, const float *input, float *cols) {
+    int in_w = layer->input_width;
+    int in_plane = layer->input_width * layer->input_height;
     int out_w = layer->output_width;
     int out_h = layer->output_height;
     int f_size = layer->filter_size;
     
-    // Pour chaque filtre
-    for (int f = 0; f < layer->num_filters; f++) {
-        for (int y = 0; y < out_h; y++) {
-            for (int x = 0; x < out_w; x++) {
-                float sum = layer->biases[f];
+    float *dst = cols;
+    for (int c = 0; c < layer->input_channels; c++) {
+        for (int fy = 0; fy < f_size; fy++) {
+            for (int fx = 0; fx < f_size; fx++) {
+                const float *src = input + c * in_plane + fy * in_w + fx;
                 
-                // Convolution sur tous les canaux d'entrée
-                for (int c = 0; c < layer->input_channels; c++) {
-                    for (int fy = 0; fy < f_size; fy++) {
-                        for (int fx = 0; fx < f_size; fx++) {
-                            int in_y = y + fy;
-                            int in_x = x + fx;
-                            
-                            int input_idx = c * (layer->input_width * layer->input_height) +
-                                          in_y * layer->input_width + in_x;
-                            int weight_idx = f * (layer->input_channels * f_size * f_size) +
-                                           c * (f_size * f_size) + fy * f_size + fx;
-                            
-                            sum += input[input_idx] * layer->weights[weight_idx];
-                        }
-                    }
+                for (int y = 0; y < out_h; y++) {
+                    memcpy(dst, src + y * in_w, out_w * sizeof(float));
+                    dst += out_w;
                 }
+            }
+        }
+    }
+}
+
+// Convolution + ReLU d'un échantillon via im2col + GEMM
+// cols: tampon de conv_im2col_size(layer) floats
+static void conv_forward_im2col(const ConvLayer *layer, const float *input,
+                                float *cols, float *output) {
+    int out_plane = layer->output_width * layer->output_height;
+    int patch = layer->input_channels * layer->filter_size * layer->filter_size;
+    
+    im2col(layer, input, cols);
+    gemm_blocked(layer->num_filters, out_plane, patch,
+                 layer->weights, patch,
+                 cols, out_plane,
+                 output, out_plane, false);
+    
+    const SimdKernels *k = simd_kernels();
+    for (int f = 0; f < layer->num_filters; f++) {
+        k->bias_relu(output + f * out_plane, layer->biases[f], out_plane);
+    }
+}
+
+// Convolution directe + ReLU d'un filtre sur un échantillon. Chaque ligne de
+// sortie est accumulée par axpy vectoriels (un par poids du noyau), dans le
+// même ordre de sommation que la boucle scalaire d'origine.
+static void conv_forward_direct_filter(const ConvLayer *layer, int f,
+                                       const float *input, float *out_plane) {
+    const SimdKernels *k = simd_kernels();
+    int in_w = layer->input_width;
+    int in_plane = layer->input_width * layer->input_height;
+    int out_w = layer->output_width;
+    int out_h = layer->output_height;
+    int f_size = layer->filter_size;
+    int f_area = f_size * f_size;
+    const float *filter = layer->weights + f * layer->input_channels * f_area;
+    float bias = layer->biases[f];
+    
+    for (int y = 0; y < out_h; y++) {
+        float *out_row = out_plane + y * out_w;
+        for (int x = 0; x < out_w; x++) {
+            out_row[x] = bias;
+        }
+        
+        for (int c = 0; c < layer->input_channels; c++) {
+            for (int fy = 0; fy < f_size; fy++) {
+                const float *in_row = input + c * in_plane + (y + fy) * in_w;
+                const float *w_row = filter + c * f_area + fy * f_size;
                 
-                // Activation ReLU
-                int out_idx = f * (out_w * out_h) + y * out_w + x;
-                layer->output_cache[out_idx] = relu(sum);
+                for (int fx = 0; fx < f_size; fx++) {
+                    k->axpy(w_row[fx], in_row + fx, out_row, out_w);
+                }
             }
         }
+        
+        k->bias_relu(out_row, 0.0f, out_w);
+    }
+}
+
+float* conv_forward(ConvLayer *layer, const float *input) {
+    // Sauvegarder l'entrée pour la backprop
+    int input_size = layer->input_channels * layer->input_width * layer->input_height;
+    memcpy(layer->input_cache, input, input_size * sizeof(float));
+    
+    if (conv_algorithm == CONV_ALGO_IM2COL) {
+        float *cols = (float*)malloc(conv_im2col_size(layer) * sizeof(float));
+        if (cols) {
+            conv_forward_im2col(layer, input, cols, layer->output_cache);
+            free(cols);
+            return layer->output_cache;
+        }
+        // Sinon, repli sur la boucle directe
+    }
+    
+    int out_plane = layer->output_width * layer->output_height;
+    
+    // Pour chaque filtre
+    for (int f = 0; f < layer->num_filters; f++) {
+        conv_forward_direct_filter(layer, f, input, layer->output_cache + f * out_plane);
     }
     
     return layer->output_cache;
@@ -208,6 +307,36 @@ float* pool_forward(PoolLayer *layer, const float *input) {
     
     float *output = (float*)malloc(layer->input_channels * out_w * out_h * sizeof(float));
     
+    if (p_size == 2) {
+        // Maxima vectorisés, puis indice du premier élément égal au maximum
+        // dans l'ordre de parcours de la fenêtre (même choix que la boucle '>')
+        const SimdKernels *k = simd_kernels();
+        int in_w = layer->input_width;
+        int in_plane = layer->input_width * layer->input_height;
+        
+        for (int c = 0; c < layer->input_channels; c++) {
+            for (int y = 0; y < out_h; y++) {
+                int row0 = c * in_plane + (2 * y) * in_w;
+                int row1 = row0 + in_w;
+                int out_row = c * (out_w * out_h) + y * out_w;
+                
+                k->max_pool2x2_row(input + row0, input + row1, output + out_row, out_w);
+                
+                for (int x = 0; x < out_w; x++) {
+                    float m = output[out_row + x];
+                    int idx = row0 + 2 * x;
+                    if (input[idx] != m) {
+                        idx = (input[idx + 1] == m) ? idx + 1 :
+                              (input[row1 + 2 * x] == m) ? row1 + 2 * x : row1 + 2 * x + 1;
+                    }
+                    layer->max_indices[out_row + x] = idx;
+                }
+            }
+        }
+        
+        return output;
+    }
+    
     for (int c = 0; c < layer->input_channels; c++) {
         for (int y = 0; y < out_h; y++) {
             for (int x = 0; x < out_w; x++) {
@@ -246,12 +375,10 @@ float* pool_forward(PoolLayer *layer, const float *input) {
 float* dense_forward(DenseLayer *layer, const float *input, bool use_relu) {
     memcpy(layer->input_cache, input, layer->input_size * sizeof(float));
     
+    const SimdKernels *k = simd_kernels();
     for (int i = 0; i < layer->output_size; i++) {
-        float sum = layer->biases[i];
-        
-        for (int j = 0; j < layer->input_size; j++) {
-            sum += input[j] * layer->weights[i * layer->input_size + j];
-        }
+        float sum = layer->biases[i] +
+                    k->dot(input, layer->weights + i * layer->input_size, layer->input_size);
         
         layer->output_cache[i] = use_relu ? relu(sum) : sum;
     }
@@ -264,6 +391,16 @@ float* dense_forward(DenseLayer *layer, const float *input, bool use_relu) {
 // ============================================================================
 
 float* cnn_forward(CNNModel *model, const float *input) {
+    // Modèle projeté: pas de caches de backprop, passage par un contexte
+    if (model->mapping) {
+        float *probabilities = (float*)malloc(10 * sizeof(float));
+        if (probabilities && !cnn_forward_batch(model, input, 1, probabilities)) {
+            free(probabilities);
+            return NULL;
+        }
+        return probabilities;
+    }
+
     // Conv1 -> Pool1
     float *out1 = conv_forward(model->conv1, input);
     float *pool1_out = pool_forward(model->pool1, out1);
@@ -285,7 +422,7 @@ float* cnn_forward(CNNModel *model, const float *input) {
     
     // Softmax
     float *probabilities = (float*)malloc(10 * sizeof(float));
-    softmax(logits, probabilities, 10);
+    simd_kernels()->softmax(logits, probabilities, 10);
     
     return probabilities;
 }
@@ -307,84 +444,629 @@ int cnn_predict(CNNModel *model, const float *input) {
     return predicted_class;
 }
 
+// ============================================================================
+// FORWARD PASS PAR LOT (INFÉRENCE RÉENTRANTE)
+// ============================================================================
+//
+// Ces fonctions ne lisent que les poids, biais et dimensions des couches et
+// n'écrivent que dans les tampons fournis: un même CNNModel peut donc servir
+// simultanément à plusieurs threads, chacun avec son InferenceContext.
+
+// Convolution + ReLU sur n échantillons. Les filtres sont parcourus en boucle
+// externe pour que chaque noyau reste en cache pendant tout le lot.
+// cols: tampon im2col (conv_im2col_size floats), utilisé si CONV_ALGO_IM2COL
+static void conv_forward_batch_layer(const ConvLayer *layer, const float *input,
+                                     int n, float *cols, float *output) {
+    if (conv_algorithm == CONV_ALGO_IM2COL) {
+        int in_size = layer->input_channels * layer->input_width * layer->input_height;
+        int out_size = layer->num_filters * layer->output_width * layer->output_height;
+        
+        for (int s = 0; s < n; s++) {
+            conv_forward_im2col(layer, input + s * in_size, cols, output + s * out_size);
+        }
+        return;
+    }
+    
+    int in_size = layer->input_channels * layer->input_width * layer->input_height;
+    int out_plane = layer->output_width * layer->output_height;
+    int out_size = layer->num_filters * out_plane;
+
+    for (int f = 0; f < layer->num_filters; f++) {
+        for (int s = 0; s < n; s++) {
+            conv_forward_direct_filter(layer, f, input + s * in_size,
+                                       output + s * out_size + f * out_plane);
+        }
+    }
+}
+
+static void pool_forward_batch_layer(const PoolLayer *layer, const float *input,
+                                     int n, float *output) {
+    int p_size = layer->pool_size;
+    int in_w = layer->input_width;
+    int in_plane = layer->input_width * layer->input_height;
+    int out_w = layer->output_width;
+    int out_h = layer->output_height;
+    int planes = n * layer->input_channels;
+
+    // En NCHW, le lot entier n'est qu'une suite de n*C plans indépendants
+    if (p_size == 2) {
+        const SimdKernels *k = simd_kernels();
+        for (int p = 0; p < planes; p++) {
+            const float *in = input + p * in_plane;
+            float *out = output + p * out_w * out_h;
+
+            for (int y = 0; y < out_h; y++) {
+                k->max_pool2x2_row(in + 2 * y * in_w, in + (2 * y + 1) * in_w,
+                                   out + y * out_w, out_w);
+            }
+        }
+        return;
+    }
+
+    for (int p = 0; p < planes; p++) {
+        const float *in = input + p * in_plane;
+        float *out = output + p * out_w * out_h;
+
+        for (int y = 0; y < out_h; y++) {
+            for (int x = 0; x < out_w; x++) {
+                float max_val = -INFINITY;
+
+                for (int py = 0; py < p_size; py++) {
+                    for (int px = 0; px < p_size; px++) {
+                        float v = in[(y * p_size + py) * in_w + x * p_size + px];
+                        if (v > max_val) max_val = v;
+                    }
+                }
+
+                out[y * out_w + x] = max_val;
+            }
+        }
+    }
+}
+
+// Couche dense sur n échantillons: chaque ligne de poids est réutilisée pour
+// tout le lot avant de passer à la suivante
+static void dense_forward_batch_layer(const DenseLayer *layer, const float *input,
+                                      int n, float *output, bool use_relu) {
+    const SimdKernels *k = simd_kernels();
+    int in_size = layer->input_size;
+    int out_size = layer->output_size;
+
+    for (int i = 0; i < out_size; i++) {
+        const float *w = layer->weights + i * in_size;
+        float bias = layer->biases[i];
+
+        for (int s = 0; s < n; s++) {
+            float sum = bias + k->dot(input + s * in_size, w, in_size);
+            output[s * out_size + i] = use_relu ? relu(sum) : sum;
+        }
+    }
+}
+
+InferenceContext* create_inference_context(const CNNModel *model, int max_batch) {
+    if (max_batch <= 0) max_batch = 1;
+
+    const ConvLayer *conv1 = model->conv1;
+    const PoolLayer *pool1 = model->pool1;
+    const ConvLayer *conv2 = model->conv2;
+    const PoolLayer *pool2 = model->pool2;
+
+    InferenceContext *ctx = (InferenceContext*)malloc(sizeof(InferenceContext));
+    if (!ctx) return NULL;
+
+    ctx->max_batch = max_batch;
+    ctx->conv1_size = (size_t)conv1->num_filters * conv1->output_width * conv1->output_height;
+    ctx->pool1_size = (size_t)pool1->input_channels * pool1->output_width * pool1->output_height;
+    ctx->conv2_size = (size_t)conv2->num_filters * conv2->output_width * conv2->output_height;
+    ctx->pool2_size = (size_t)pool2->input_channels * pool2->output_width * pool2->output_height;
+    ctx->fc1_size = model->fc1->output_size;
+    ctx->fc2_size = model->fc2->output_size;
+
+    // Un seul bloc pour toutes les activations du lot (+ tampon im2col partagé)
+    size_t per_sample = ctx->conv1_size + ctx->pool1_size + ctx->conv2_size +
+                        ctx->pool2_size + ctx->fc1_size + ctx->fc2_size;
+    size_t cols_size = max_int(conv_im2col_size(conv1), conv_im2col_size(conv2));
+    ctx->buffer = (float*)malloc((max_batch * per_sample + cols_size) * sizeof(float));
+    if (!ctx->buffer) {
+        LOG_ERROR("create_inference_context: allocation impossible (lot de %d)", max_batch);
+        free(ctx);
+        return NULL;
+    }
+
+    ctx->conv1_out = ctx->buffer;
+    ctx->pool1_out = ctx->conv1_out + max_batch * ctx->conv1_size;
+    ctx->conv2_out = ctx->pool1_out + max_batch * ctx->pool1_size;
+    ctx->pool2_out = ctx->conv2_out + max_batch * ctx->conv2_size;
+    ctx->fc1_out = ctx->pool2_out + max_batch * ctx->pool2_size;
+    ctx->logits = ctx->fc1_out + max_batch * ctx->fc1_size;
+    ctx->cols = ctx->logits + max_batch * ctx->fc2_size;
+
+    // Résoudre la table SIMD ici, avant que des threads ne l'utilisent
+    simd_kernels();
+
+    return ctx;
+}
+
+void free_inference_context(InferenceContext *ctx) {
+    if (!ctx) return;
+    free(ctx->buffer);
+    free(ctx);
+}
+
+bool cnn_forward_ctx(const CNNModel *model, InferenceContext *ctx,
+                     const float *inputs, int n, float *probs_out) {
+    const SimdKernels *k = simd_kernels();
+    int input_size = model->conv1->input_channels * model->conv1->input_width *
+                     model->conv1->input_height;
+
+    // Les lots plus grands que le contexte sont traités par tranches
+    for (int start = 0; start < n; start += ctx->max_batch) {
+        int count = min_int(ctx->max_batch, n - start);
+        const float *in = inputs + (size_t)start * input_size;
+        float *probs = probs_out + (size_t)start * ctx->fc2_size;
+
+        conv_forward_batch_layer(model->conv1, in, count, ctx->cols, ctx->conv1_out);
+        pool_forward_batch_layer(model->pool1, ctx->conv1_out, count, ctx->pool1_out);
+        conv_forward_batch_layer(model->conv2, ctx->pool1_out, count, ctx->cols, ctx->conv2_out);
+        pool_forward_batch_layer(model->pool2, ctx->conv2_out, count, ctx->pool2_out);
+        dense_forward_batch_layer(model->fc1, ctx->pool2_out, count, ctx->fc1_out, true);
+        dense_forward_batch_layer(model->fc2, ctx->fc1_out, count, ctx->logits, false);
+
+        for (int s = 0; s < count; s++) {
+            k->softmax(ctx->logits + s * ctx->fc2_size, probs + s * ctx->fc2_size, ctx->fc2_size);
+        }
+    }
+
+    return true;
+}
+
+bool cnn_forward_batch(CNNModel *model, const float *inputs, int n, float *probs_out) {
+    if (n <= 0) return true;
+
+    InferenceContext *ctx = create_inference_context(model, n);
+    if (!ctx) return false;
+
+    bool ok = cnn_forward_ctx(model, ctx, inputs, n, probs_out);
+    free_inference_context(ctx);
+    return ok;
+}
+
 // ============================================================================
 // SAUVEGARDE ET CHARGEMENT
 // ============================================================================
 
+#define CNN_FILE_MAGIC      0x464E4E43u  // "CNNF"
+#define CNN_LEGACY_MAGIC    0x434E4E57u  // "CNNW" (poids bruts sans en-tête)
+#define CNN_FILE_ALIGN      64
+#define CNN_TENSOR_COUNT    8
+#define CNN_DTYPE_F32       1
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t tensor_count;
+    uint32_t alignment;
+    uint64_t file_size;
+    uint32_t checksum;          // FNV-1a de [64, file_size)
+    uint32_t input_channels;
+    uint32_t input_height;
+    uint32_t input_width;
+    uint32_t pool1_size;
+    uint32_t pool2_size;
+    uint32_t reserved[4];
+} CNNFileHeader;
+
+typedef struct {
+    char name[24];
+    uint32_t dtype;
+    uint32_t ndim;
+    uint32_t shape[4];
+    uint64_t offset;            // Depuis le début du fichier, multiple de 64
+    uint64_t size;              // En octets
+} CNNTensorEntry;
+
+// Les deux structures font exactement 64 octets (vérifié à la compilation)
+typedef char cnn_header_size_check[(sizeof(CNNFileHeader) == 64) ? 1 : -1];
+typedef char cnn_entry_size_check[(sizeof(CNNTensorEntry) == 64) ? 1 : -1];
+
+// Description d'un tenseur du modèle (ordre de sérialisation)
+typedef struct {
+    const char *name;
+    float *data;
+    uint32_t ndim;
+    uint32_t shape[4];
+} TensorRef;
+
+static uint32_t fnv1a(const uint8_t *data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static size_t tensor_count_floats(const TensorRef *t) {
+    size_t count = 1;
+    for (uint32_t d = 0; d < t->ndim; d++) count *= t->shape[d];
+    return count;
+}
+
+static size_t align_up(size_t value) {
+    return (value + CNN_FILE_ALIGN - 1) & ~(size_t)(CNN_FILE_ALIGN - 1);
+}
+
+static void fill_tensor_refs(const CNNModel *model, TensorRef refs[CNN_TENSOR_COUNT]) {
+    const ConvLayer *c1 = model->conv1;
+    const ConvLayer *c2 = model->conv2;
+    const DenseLayer *f1 = model->fc1;
+    const DenseLayer *f2 = model->fc2;
+
+    TensorRef table[CNN_TENSOR_COUNT] = {
+        {"conv1.weight", c1->weights, 4,
+         {c1->num_filters, c1->input_channels, c1->filter_size, c1->filter_size}},
+        {"conv1.bias", c1->biases, 1, {c1->num_filters, 0, 0, 0}},
+        {"conv2.weight", c2->weights, 4,
+         {c2->num_filters, c2->input_channels, c2->filter_size, c2->filter_size}},
+        {"conv2.bias", c2->biases, 1, {c2->num_filters, 0, 0, 0}},
+        {"fc1.weight", f1->weights, 2, {f1->output_size, f1->input_size, 0, 0}},
+        {"fc1.bias", f1->biases, 1, {f1->output_size, 0, 0, 0}},
+        {"fc2.weight", f2->weights, 2, {f2->output_size, f2->input_size, 0, 0}},
+        {"fc2.bias", f2->biases, 1, {f2->output_size, 0, 0, 0}},
+    };
+    memcpy(refs, table, sizeof(table));
+}
+
 bool save_cnn_weights(const CNNModel *model, const char *filename) {
+    TensorRef refs[CNN_TENSOR_COUNT];
+    fill_tensor_refs(model, refs);
+
+    // Calcul de la disposition: en-tête, table, puis tenseurs alignés
+    size_t offset = align_up(sizeof(CNNFileHeader) + CNN_TENSOR_COUNT * sizeof(CNNTensorEntry));
+    size_t offsets[CNN_TENSOR_COUNT];
+    for (int t = 0; t < CNN_TENSOR_COUNT; t++) {
+        offsets[t] = offset;
+        offset = align_up(offset + tensor_count_floats(&refs[t]) * sizeof(float));
+    }
+    size_t file_size = offset;
+
+    uint8_t *buffer = (uint8_t*)calloc(file_size, 1);
+    if (!buffer) {
+        LOG_ERROR("Allocation impossible pour la sauvegarde des poids");
+        return false;
+    }
+
+    CNNTensorEntry *entries = (CNNTensorEntry*)(buffer + sizeof(CNNFileHeader));
+    for (int t = 0; t < CNN_TENSOR_COUNT; t++) {
+        size_t bytes = tensor_count_floats(&refs[t]) * sizeof(float);
+
+        strncpy(entries[t].name, refs[t].name, sizeof(entries[t].name) - 1);
+        entries[t].dtype = CNN_DTYPE_F32;
+        entries[t].ndim = refs[t].ndim;
+        memcpy(entries[t].shape, refs[t].shape, sizeof(entries[t].shape));
+        entries[t].offset = offsets[t];
+        entries[t].size = bytes;
+        memcpy(buffer + offsets[t], refs[t].data, bytes);
+    }
+
+    CNNFileHeader *header = (CNNFileHeader*)buffer;
+    header->magic = CNN_FILE_MAGIC;
+    header->version = CNN_FILE_VERSION;
+    header->tensor_count = CNN_TENSOR_COUNT;
+    header->alignment = CNN_FILE_ALIGN;
+    header->file_size = file_size;
+    header->input_channels = model->conv1->input_channels;
+    header->input_height = model->conv1->input_height;
+    header->input_width = model->conv1->input_width;
+    header->pool1_size = model->pool1->pool_size;
+    header->pool2_size = model->pool2->pool_size;
+    header->checksum = fnv1a(buffer + sizeof(CNNFileHeader), file_size - sizeof(CNNFileHeader));
+
     FILE *file = fopen(filename, "wb");
     if (!file) {
         LOG_ERROR("Impossible de sauvegarder les poids: %s", filename);
+        free(buffer);
+        return false;
+    }
+
+    bool ok = fwrite(buffer, 1, file_size, file) == file_size;
+    ok = (fclose(file) == 0) && ok;
+    free(buffer);
+
+    if (!ok) {
+        LOG_ERROR("Écriture incomplète: %s", filename);
         return false;
     }
-    
-    // Magic number pour vérification
-    uint32_t magic = 0x434E4E57;  // "CNNW"
-    fwrite(&magic, sizeof(uint32_t), 1, file);
-    
-    // Conv1
-    fwrite(model->conv1->weights, sizeof(float), 
-           model->conv1->num_filters * model->conv1->input_channels * 
-           model->conv1->filter_size * model->conv1->filter_size, file);
-    fwrite(model->conv1->biases, sizeof(float), model->conv1->num_filters, file);
-    
-    // Conv2
-    fwrite(model->conv2->weights, sizeof(float), 
-           model->conv2->num_filters * model->conv2->input_channels * 
-           model->conv2->filter_size * model->conv2->filter_size, file);
-    fwrite(model->conv2->biases, sizeof(float), model->conv2->num_filters, file);
-    
-    // FC1
-    fwrite(model->fc1->weights, sizeof(float), 
-           model->fc1->input_size * model->fc1->output_size, file);
-    fwrite(model->fc1->biases, sizeof(float), model->fc1->output_size, file);
-    
-    // FC2
-    fwrite(model->fc2->weights, sizeof(float), 
-           model->fc2->input_size * model->fc2->output_size, file);
-    fwrite(model->fc2->biases, sizeof(float), model->fc2->output_size, file);
-    
-    fclose(file);
     LOG_INFO("Poids sauvegardés: %s", filename);
     return true;
 }
 
+// Vérifie l'en-tête, la table et le checksum d'un fichier projeté
+static const CNNFileHeader* validate_model_file(const uint8_t *data, size_t size,
+                                                const char *filename) {
+    if (size < sizeof(CNNFileHeader)) {
+        LOG_ERROR("Fichier de poids tronqué: %s", filename);
+        return NULL;
+    }
+
+    const CNNFileHeader *header = (const CNNFileHeader*)data;
+    if (header->magic != CNN_FILE_MAGIC) {
+        LOG_ERROR("Format de fichier invalide: %s", filename);
+        return NULL;
+    }
+    if (header->version != CNN_FILE_VERSION) {
+        LOG_ERROR("Version de fichier non supportée (%u): %s", header->version, filename);
+        return NULL;
+    }
+    if (header->file_size != size || header->alignment != CNN_FILE_ALIGN ||
+        header->tensor_count != CNN_TENSOR_COUNT ||
+        sizeof(CNNFileHeader) + CNN_TENSOR_COUNT * sizeof(CNNTensorEntry) > size) {
+        LOG_ERROR("En-tête incohérent: %s", filename);
+        return NULL;
+    }
+
+    const CNNTensorEntry *entries = (const CNNTensorEntry*)(data + sizeof(CNNFileHeader));
+    for (uint32_t t = 0; t < header->tensor_count; t++) {
+        if (entries[t].dtype != CNN_DTYPE_F32 || entries[t].offset % CNN_FILE_ALIGN != 0 ||
+            entries[t].offset > size || entries[t].size > size - entries[t].offset) {
+            LOG_ERROR("Tenseur %u invalide: %s", t, filename);
+            return NULL;
+        }
+    }
+
+    uint32_t checksum = fnv1a(data + sizeof(CNNFileHeader), size - sizeof(CNNFileHeader));
+    if (checksum != header->checksum) {
+        LOG_ERROR("Checksum invalide (fichier corrompu): %s", filename);
+        return NULL;
+    }
+    return header;
+}
+
+// Cherche un tenseur par nom et vérifie qu'il a la forme attendue
+static const float* find_tensor(const uint8_t *data, const TensorRef *expected) {
+    const CNNFileHeader *header = (const CNNFileHeader*)data;
+    const CNNTensorEntry *entries = (const CNNTensorEntry*)(data + sizeof(CNNFileHeader));
+
+    for (uint32_t t = 0; t < header->tensor_count; t++) {
+        if (strncmp(entries[t].name, expected->name, sizeof(entries[t].name)) != 0) continue;
+
+        if (entries[t].ndim != expected->ndim ||
+            memcmp(entries[t].shape, expected->shape, expected->ndim * sizeof(uint32_t)) != 0 ||
+            entries[t].size != tensor_count_floats(expected) * sizeof(float)) {
+            LOG_ERROR("Forme inattendue pour %s", expected->name);
+            return NULL;
+        }
+        return (const float*)(data + entries[t].offset);
+    }
+
+    LOG_ERROR("Tenseur manquant: %s", expected->name);
+    return NULL;
+}
+
+// Projette un fichier en lecture seule. Returns: NULL en cas d'erreur
+static uint8_t* map_file(const char *filename, size_t *size_out) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+
+    *size_out = (size_t)st.st_size;
+    return (uint8_t*)data;
+}
+
+// Ancien format: magic "CNNW" suivi des tableaux float bruts
+static bool load_legacy_weights(CNNModel *model, FILE *file) {
+    TensorRef refs[CNN_TENSOR_COUNT];
+    fill_tensor_refs(model, refs);
+
+    for (int t = 0; t < CNN_TENSOR_COUNT; t++) {
+        size_t count = tensor_count_floats(&refs[t]);
+        if (fread(refs[t].data, sizeof(float), count, file) != count) return false;
+    }
+    return true;
+}
+
 bool load_cnn_weights(CNNModel *model, const char *filename) {
     FILE *file = fopen(filename, "rb");
     if (!file) {
         LOG_ERROR("Impossible de charger les poids: %s", filename);
         return false;
     }
-    
-    // Vérifier le magic number
-    uint32_t magic;
-    fread(&magic, sizeof(uint32_t), 1, file);
-    if (magic != 0x434E4E57) {
-        LOG_ERROR("Format de fichier invalide");
+
+    uint32_t magic = 0;
+    if (fread(&magic, sizeof(uint32_t), 1, file) != 1) magic = 0;
+
+    if (magic == CNN_LEGACY_MAGIC) {
+        bool ok = load_legacy_weights(model, file);
         fclose(file);
-        return false;
+        if (!ok) {
+            LOG_ERROR("Fichier de poids tronqué: %s", filename);
+            return false;
+        }
+        LOG_INFO("Poids chargés (ancien format): %s", filename);
+        return true;
     }
-    
-    // Charger les poids (même ordre que la sauvegarde)
-    fread(model->conv1->weights, sizeof(float), 
-          model->conv1->num_filters * model->conv1->input_channels * 
-          model->conv1->filter_size * model->conv1->filter_size, file);
-    fread(model->conv1->biases, sizeof(float), model->conv1->num_filters, file);
-    
-    fread(model->conv2->weights, sizeof(float), 
-          model->conv2->num_filters * model->conv2->input_channels * 
-          model->conv2->filter_size * model->conv2->filter_size, file);
-    fread(model->conv2->biases, sizeof(float), model->conv2->num_filters, file);
-    
-    fread(model->fc1->weights, sizeof(float), 
-          model->fc1->input_size * model->fc1->output_size, file);
-    fread(model->fc1->biases, sizeof(float), model->fc1->output_size, file);
-    
-    fread(model->fc2->weights, sizeof(float), 
-          model->fc2->input_size * model->fc2->output_size, file);
-    fread(model->fc2->biases, sizeof(float), model->fc2->output_size, file);
-    
     fclose(file);
-    LOG_INFO("Poids chargés: %s", filename);
-    return true;
+
+    size_t size = 0;
+    uint8_t *data = map_file(filename, &size);
+    if (!data) {
+        LOG_ERROR("Impossible de charger les poids: %s", filename);
+        return false;
+    }
+
+    bool ok = validate_model_file(data, size, filename) != NULL;
+
+    TensorRef refs[CNN_TENSOR_COUNT];
+    fill_tensor_refs(model, refs);
+    for (int t = 0; ok && t < CNN_TENSOR_COUNT; t++) {
+        const float *src = find_tensor(data, &refs[t]);
+        if (src) {
+            memcpy(refs[t].data, src, tensor_count_floats(&refs[t]) * sizeof(float));
+        } else {
+            ok = false;
+        }
+    }
+
+    munmap(data, size);
+    if (ok) LOG_INFO("Poids chargés: %s", filename);
+    return ok;
+}
+
+// Couches dont les paramètres pointent dans la projection. Seuls les caches
+// d'activation du forward pass mono-image sont alloués (pas de gradients).
+static ConvLayer* create_mapped_conv_layer(const uint8_t *data, const char *weight_name,
+                                           const char *bias_name, int num_filters,
+                                           int filter_size, int input_channels,
+                                           int input_width, int input_height) {
+    TensorRef w = {weight_name, NULL, 4, {num_filters, input_channels, filter_size, filter_size}};
+    TensorRef b = {bias_name, NULL, 1, {num_filters, 0, 0, 0}};
+    const float *weights = find_tensor(data, &w);
+    const float *biases = find_tensor(data, &b);
+    if (!weights || !biases) return NULL;
+
+    ConvLayer *layer = (ConvLayer*)calloc(1, sizeof(ConvLayer));
+    if (!layer) return NULL;
+
+    layer->num_filters = num_filters;
+    layer->filter_size = filter_size;
+    layer->input_channels = input_channels;
+    layer->input_width = input_width;
+    layer->input_height = input_height;
+    layer->output_width = input_width - filter_size + 1;
+    layer->output_height = input_height - filter_size + 1;
+
+    // Pages en lecture seule: le forward pass ne fait que lire les poids
+    layer->weights = (float*)weights;
+    layer->biases = (float*)biases;
+    return layer;
+}
+
+static DenseLayer* create_mapped_dense_layer(const uint8_t *data, const char *weight_name,
+                                             const char *bias_name, int input_size,
+                                             int output_size) {
+    TensorRef w = {weight_name, NULL, 2, {output_size, input_size, 0, 0}};
+    TensorRef b = {bias_name, NULL, 1, {output_size, 0, 0, 0}};
+    const float *weights = find_tensor(data, &w);
+    const float *biases = find_tensor(data, &b);
+    if (!weights || !biases) return NULL;
+
+    DenseLayer *layer = (DenseLayer*)calloc(1, sizeof(DenseLayer));
+    if (!layer) return NULL;
+
+    layer->input_size = input_size;
+    layer->output_size = output_size;
+    layer->weights = (float*)weights;
+    layer->biases = (float*)biases;
+    return layer;
+}
+
+// Couche de pooling d'un modèle projeté: formes seules, sans caches
+static PoolLayer* create_mapped_pool_layer(int pool_size, int input_channels,
+                                           int input_width, int input_height) {
+    PoolLayer *layer = (PoolLayer*)calloc(1, sizeof(PoolLayer));
+    if (!layer) return NULL;
+
+    layer->pool_size = pool_size;
+    layer->input_channels = input_channels;
+    layer->input_width = input_width;
+    layer->input_height = input_height;
+    layer->output_width = input_width / pool_size;
+    layer->output_height = input_height / pool_size;
+    return layer;
+}
+
+// Lit la forme d'un tenseur (dimension dim) dans la table. Returns: 0 si absent
+static int tensor_dim(const uint8_t *data, const char *name, uint32_t dim) {
+    const CNNFileHeader *header = (const CNNFileHeader*)data;
+    const CNNTensorEntry *entries = (const CNNTensorEntry*)(data + sizeof(CNNFileHeader));
+
+    for (uint32_t t = 0; t < header->tensor_count; t++) {
+        if (strncmp(entries[t].name, name, sizeof(entries[t].name)) == 0 && dim < entries[t].ndim) {
+            return (int)entries[t].shape[dim];
+        }
+    }
+    return 0;
+}
+
+CNNModel* map_cnn_model(const char *filename) {
+    size_t size = 0;
+    uint8_t *data = map_file(filename, &size);
+    if (!data) {
+        LOG_ERROR("Impossible de projeter les poids: %s", filename);
+        return NULL;
+    }
+
+    if (size >= sizeof(uint32_t) && *(const uint32_t*)data == CNN_LEGACY_MAGIC) {
+        LOG_INFO("Ancien format de poids (copie nécessaire): %s", filename);
+        munmap(data, size);
+        return NULL;
+    }
+
+    const CNNFileHeader *header = validate_model_file(data, size, filename);
+    CNNModel *model = header ? (CNNModel*)calloc(1, sizeof(CNNModel)) : NULL;
+    if (!model) {
+        munmap(data, size);
+        return NULL;
+    }
+
+    // Architecture reconstruite d'après l'en-tête et les formes des tenseurs
+    int in_c = header->input_channels;
+    int in_w = header->input_width;
+    int in_h = header->input_height;
+    int c1_filters = tensor_dim(data, "conv1.weight", 0);
+    int c1_size = tensor_dim(data, "conv1.weight", 2);
+    int c2_filters = tensor_dim(data, "conv2.weight", 0);
+    int c2_size = tensor_dim(data, "conv2.weight", 2);
+    int fc1_out = tensor_dim(data, "fc1.weight", 0);
+    int fc2_out = tensor_dim(data, "fc2.weight", 0);
+    int p1 = header->pool1_size;
+    int p2 = header->pool2_size;
+
+    model->mapping = data;
+    model->mapping_size = size;
+
+    if (c1_filters > 0 && c1_size > 0 && c2_filters > 0 && c2_size > 0 && p1 > 0 && p2 > 0 &&
+        in_w >= c1_size && in_h >= c1_size) {
+        model->conv1 = create_mapped_conv_layer(data, "conv1.weight", "conv1.bias",
+                                                c1_filters, c1_size, in_c, in_w, in_h);
+    }
+    if (model->conv1) {
+        model->pool1 = create_mapped_pool_layer(p1, c1_filters, model->conv1->output_width,
+                                                model->conv1->output_height);
+    }
+    if (model->pool1) {
+        model->conv2 = create_mapped_conv_layer(data, "conv2.weight", "conv2.bias",
+                                                c2_filters, c2_size, c1_filters,
+                                                model->pool1->output_width,
+                                                model->pool1->output_height);
+    }
+    if (model->conv2) {
+        model->pool2 = create_mapped_pool_layer(p2, c2_filters, model->conv2->output_width,
+                                                model->conv2->output_height);
+    }
+    if (model->pool2) {
+        int flat = c2_filters * model->pool2->output_width * model->pool2->output_height;
+        model->fc1 = create_mapped_dense_layer(data, "fc1.weight", "fc1.bias", flat, fc1_out);
+    }
+    if (model->fc1) {
+        model->fc2 = create_mapped_dense_layer(data, "fc2.weight", "fc2.bias", fc1_out, fc2_out);
+    }
+
+    if (!model->fc2) {
+        LOG_ERROR("Architecture incohérente dans %s", filename);
+        free_cnn_model(model);  // Tolère les couches manquantes, libère la projection
+        return NULL;
+    }
+
+    LOG_INFO("Poids projetés en mémoire (%zu octets, sans copie): %s", size, filename);
+    return model;
 }
@@ -65,6 +65,9 @@ typedef struct {
     PoolLayer *pool2;       // 2ème max pooling
     DenseLayer *fc1;        // Couche dense 1
     DenseLayer *fc2;        // Couche dense 2 (sortie)
+
+    void *mapping;          // Fichier de poids mmap (map_cnn_model) ou NULL
+    size_t mapping_size;
 } CNNModel;
 
 // ============================================================================
@@ -89,6 +92,18 @@ void free_cnn_model(CNNModel *model);
 // FORWARD PASS
 // ============================================================================
 
+// Algorithme utilisé par les couches de convolution
+typedef enum {
+    CONV_ALGO_DIRECT,       // Boucle directe (6 niveaux)
+    CONV_ALGO_IM2COL        // Dépliage im2col + produit matriciel bloqué
+} ConvAlgorithm;
+
+// Sélectionne l'algorithme de convolution (global, par défaut CONV_ALGO_IM2COL)
+// Les deux algorithmes utilisent les mêmes poids et donnent le même résultat
+// aux arrondis flottants près.
+void cnn_set_conv_algorithm(ConvAlgorithm algo);
+ConvAlgorithm cnn_get_conv_algorithm(void);
+
 // Forward pass d'une couche de convolution
 float* conv_forward(ConvLayer *layer, const float *input);
 
@@ -104,11 +119,74 @@ float* cnn_forward(CNNModel *model, const float *input);
 // Prédiction (retourne la classe prédite 0-9)
 int cnn_predict(CNNModel *model, const float *input);
 
+// ============================================================================
+// INFÉRENCE RÉENTRANTE
+// ============================================================================
+
+// Activations d'un thread d'inférence. Les poids restent dans le CNNModel,
+// qui n'est jamais modifié par ce chemin (ni caches de backprop, ni copies):
+// N threads peuvent partager un seul modèle avec chacun leur contexte.
+typedef struct {
+    int max_batch;          // Nombre max d'échantillons traités en une passe
+
+    // Tailles par échantillon (en floats)
+    size_t conv1_size, pool1_size, conv2_size, pool2_size, fc1_size, fc2_size;
+
+    float *buffer;          // Bloc unique contenant toutes les activations
+    float *conv1_out;
+    float *pool1_out;
+    float *conv2_out;
+    float *pool2_out;
+    float *fc1_out;
+    float *logits;
+    float *cols;            // Tampon im2col partagé par les deux convolutions
+} InferenceContext;
+
+// Crée un contexte dimensionné pour des lots de max_batch images
+InferenceContext* create_inference_context(const CNNModel *model, int max_batch);
+void free_inference_context(InferenceContext *ctx);
+
+// Forward pass réentrant: n images 28x28 contiguës (NCHW), n quelconque
+// (traité par tranches de ctx->max_batch). probs_out: n x 10 probabilités.
+bool cnn_forward_ctx(const CNNModel *model, InferenceContext *ctx,
+                     const float *inputs, int n, float *probs_out);
+
+// Forward pass par lot: n images 28x28 contiguës (tenseur NCHW, C=1)
+// Chaque couche traite tout le lot avant de passer à la suivante, de sorte que
+// ses poids ne transitent qu'une fois par le cache. Les caches de backprop ne
+// sont pas modifiés.
+// probs_out: n x 10 probabilités softmax (allouées par l'appelant)
+// Raccourci qui crée un InferenceContext temporaire.
+// Returns: false en cas d'échec d'allocation
+bool cnn_forward_batch(CNNModel *model, const float *inputs, int n, float *probs_out);
+
 // ============================================================================
 // SAUVEGARDE ET CHARGEMENT
 // ============================================================================
 
+// Format de fichier (version CNN_FILE_VERSION, little-endian):
+//   [0, 64)     en-tête: magic "CNNF", version, nombre de tenseurs, alignement,
+//               taille du fichier, checksum FNV-1a, dimensions d'entrée, pooling
+//   [64, ...)   table des tenseurs (64 octets chacun): nom, dtype, forme, offset
+//   données     tenseurs float32 alignés sur 64 octets, utilisables en place
+// Le checksum couvre tout ce qui suit l'en-tête (table et données).
+#define CNN_FILE_VERSION 1
+
+// Sauvegarde au format versionné
 bool save_cnn_weights(const CNNModel *model, const char *filename);
+
+// Charge des poids par copie dans un modèle existant (formes vérifiées)
+// Accepte le format versionné et l'ancien format brut "CNNW"
 bool load_cnn_weights(CNNModel *model, const char *filename);
 
+// Projette un fichier au format versionné en mémoire (mmap lecture seule) et
+// construit un modèle dont les poids pointent directement dans le fichier:
+// démarrage sans copie, pages partagées entre processus via le page cache.
+// Le modèle ne porte que les formes et les poids, en lecture seule: ni
+// gradients ni caches de backprop, aucun état modifiable. Les activations
+// vivent dans les InferenceContext; cnn_forward() et cnn_predict() passent par
+// un contexte temporaire. free_cnn_model() libère la projection.
+// Returns: NULL si le fichier est absent, invalide ou à l'ancien format
+CNNModel* map_cnn_model(const char *filename);
+
 #endif // CNN_MODEL_H
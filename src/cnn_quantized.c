@@ -0,0 +1,376 @@
+#include "cnn_quantized.h"
+#include "simd_kernels.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// ============================================================================
+// QUANTIFICATION DES POIDS
+// ============================================================================
+
+// Quantification symétrique int8 ligne par ligne (un facteur par canal de sortie)
+// scales[r] = max|w[r]| / 127, q = round(w / scale)
+static void quantize_rows(const float *weights, int rows, int cols,
+                          int8_t *q, float *scales) {
+    for (int r = 0; r < rows; r++) {
+        const float *w = weights + r * cols;
+        int8_t *q_row = q + r * cols;
+        float max_abs = 0.0f;
+
+        for (int c = 0; c < cols; c++) {
+            if (fabsf(w[c]) > max_abs) max_abs = fabsf(w[c]);
+        }
+
+        float scale = (max_abs > 0.0f) ? max_abs / 127.0f : 1.0f;
+        scales[r] = scale;
+
+        for (int c = 0; c < cols; c++) {
+            float v = roundf(w[c] / scale);
+            q_row[c] = (int8_t)clamp(v, -127.0f, 127.0f);
+        }
+    }
+}
+
+// Échelle uint8 d'une activation positive de maximum observé max_val
+static float activation_scale(float max_val) {
+    return (max_val > 0.0f) ? max_val / 255.0f : 1.0f / 255.0f;
+}
+
+static bool init_qconv(QConvLayer *q, const ConvLayer *layer, float input_scale) {
+    q->num_filters = layer->num_filters;
+    q->filter_size = layer->filter_size;
+    q->input_channels = layer->input_channels;
+    q->input_width = layer->input_width;
+    q->input_height = layer->input_height;
+    q->output_width = layer->output_width;
+    q->output_height = layer->output_height;
+
+    int patch = layer->input_channels * layer->filter_size * layer->filter_size;
+    q->weights = (int8_t*)malloc(layer->num_filters * patch * sizeof(int8_t));
+    q->biases = (float*)malloc(layer->num_filters * sizeof(float));
+    q->requant = (float*)malloc(layer->num_filters * sizeof(float));
+    if (!q->weights || !q->biases || !q->requant) return false;
+
+    quantize_rows(layer->weights, layer->num_filters, patch, q->weights, q->requant);
+    for (int f = 0; f < layer->num_filters; f++) {
+        q->requant[f] *= input_scale;
+    }
+    memcpy(q->biases, layer->biases, layer->num_filters * sizeof(float));
+    return true;
+}
+
+static bool init_qdense(QDenseLayer *q, const DenseLayer *layer, float input_scale) {
+    q->input_size = layer->input_size;
+    q->output_size = layer->output_size;
+
+    q->weights = (int8_t*)malloc(layer->input_size * layer->output_size * sizeof(int8_t));
+    q->biases = (float*)malloc(layer->output_size * sizeof(float));
+    q->requant = (float*)malloc(layer->output_size * sizeof(float));
+    if (!q->weights || !q->biases || !q->requant) return false;
+
+    quantize_rows(layer->weights, layer->output_size, layer->input_size, q->weights, q->requant);
+    for (int i = 0; i < layer->output_size; i++) {
+        q->requant[i] *= input_scale;
+    }
+    memcpy(q->biases, layer->biases, layer->output_size * sizeof(float));
+    return true;
+}
+
+// ============================================================================
+// CALIBRATION DES ACTIVATIONS
+// ============================================================================
+
+static float max_of(const float *data, size_t count) {
+    float m = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        if (data[i] > m) m = data[i];
+    }
+    return m;
+}
+
+// Passe les images de calibration dans le modèle float et relève le maximum
+// de chaque activation quantifiée (sorties conv1, conv2 et fc1 après ReLU;
+// le max pooling ne change pas le maximum)
+static bool calibrate(const CNNModel *model, float * const *images, int count,
+                      float *conv1_max, float *conv2_max, float *fc1_max) {
+    const int batch = 64;
+    int image_size = model->conv1->input_width * model->conv1->input_height *
+                     model->conv1->input_channels;
+
+    InferenceContext *ctx = create_inference_context(model, batch);
+    float *inputs = (float*)malloc(batch * image_size * sizeof(float));
+    float *probs = (float*)malloc(batch * model->fc2->output_size * sizeof(float));
+    if (!ctx || !inputs || !probs) {
+        free_inference_context(ctx);
+        free(inputs);
+        free(probs);
+        return false;
+    }
+
+    *conv1_max = *conv2_max = *fc1_max = 0.0f;
+
+    for (int start = 0; start < count; start += batch) {
+        int n = min_int(batch, count - start);
+        for (int i = 0; i < n; i++) {
+            memcpy(inputs + i * image_size, images[start + i], image_size * sizeof(float));
+        }
+
+        cnn_forward_ctx(model, ctx, inputs, n, probs);
+
+        *conv1_max = max_float(*conv1_max, max_of(ctx->conv1_out, n * ctx->conv1_size));
+        *conv2_max = max_float(*conv2_max, max_of(ctx->conv2_out, n * ctx->conv2_size));
+        *fc1_max = max_float(*fc1_max, max_of(ctx->fc1_out, n * ctx->fc1_size));
+    }
+
+    free_inference_context(ctx);
+    free(inputs);
+    free(probs);
+    return true;
+}
+
+QuantizedCNNModel* quantize_cnn_model(const CNNModel *model,
+                                      float * const *calib_images, int calib_count) {
+    if (!calib_images || calib_count <= 0) {
+        LOG_ERROR("quantize_cnn_model: aucune image de calibration");
+        return NULL;
+    }
+
+    float conv1_max, conv2_max, fc1_max;
+    if (!calibrate(model, calib_images, calib_count, &conv1_max, &conv2_max, &fc1_max)) {
+        LOG_ERROR("quantize_cnn_model: échec de la calibration");
+        return NULL;
+    }
+
+    QuantizedCNNModel *q = (QuantizedCNNModel*)calloc(1, sizeof(QuantizedCNNModel));
+    if (!q) return NULL;
+
+    q->input_scale = 1.0f / 255.0f;
+    q->pool1_size = model->pool1->pool_size;
+    q->pool2_size = model->pool2->pool_size;
+
+    bool ok = init_qconv(&q->conv1, model->conv1, q->input_scale);
+    q->conv1.output_scale = activation_scale(conv1_max);
+
+    ok = ok && init_qconv(&q->conv2, model->conv2, q->conv1.output_scale);
+    q->conv2.output_scale = activation_scale(conv2_max);
+
+    ok = ok && init_qdense(&q->fc1, model->fc1, q->conv2.output_scale);
+    q->fc1.output_scale = activation_scale(fc1_max);
+
+    ok = ok && init_qdense(&q->fc2, model->fc2, q->fc1.output_scale);
+    q->fc2.output_scale = 0.0f;
+
+    if (!ok) {
+        LOG_ERROR("quantize_cnn_model: allocation impossible");
+        free_quantized_model(q);
+        return NULL;
+    }
+
+    LOG_INFO("Modèle quantifié int8 (calibration sur %d images, max conv1=%.2f conv2=%.2f fc1=%.2f)",
+             calib_count, conv1_max, conv2_max, fc1_max);
+    return q;
+}
+
+void free_quantized_model(QuantizedCNNModel *qmodel) {
+    if (!qmodel) return;
+    free(qmodel->conv1.weights);
+    free(qmodel->conv1.biases);
+    free(qmodel->conv1.requant);
+    free(qmodel->conv2.weights);
+    free(qmodel->conv2.biases);
+    free(qmodel->conv2.requant);
+    free(qmodel->fc1.weights);
+    free(qmodel->fc1.biases);
+    free(qmodel->fc1.requant);
+    free(qmodel->fc2.weights);
+    free(qmodel->fc2.biases);
+    free(qmodel->fc2.requant);
+    free(qmodel);
+}
+
+// ============================================================================
+// FORWARD PASS INT8
+// ============================================================================
+
+// Remise à l'échelle + ReLU + quantification uint8 d'un accumulateur int32:
+// q = clamp(round(acc * scale + offset), 0, 255), avec scale et offset
+// précalculés (requant / out_scale, bias / out_scale). Sans branche pour
+// que les boucles appelantes se vectorisent.
+static inline uint8_t requantize_relu(int32_t acc, float scale, float offset) {
+    int v = (int)((float)acc * scale + offset + 0.5f);
+    v = (v < 0) ? 0 : v;
+    v = (v > 255) ? 255 : v;
+    return (uint8_t)v;
+}
+
+// Nombre de paires de lignes im2col (la dernière est complétée par des zéros)
+static int qconv_pairs(const QConvLayer *layer) {
+    return (layer->input_channels * layer->filter_size * layer->filter_size + 1) / 2;
+}
+
+// Convolution int8. L'im2col produit des paires de lignes de patch entrelacées
+// en int16 (cols[paire][pixel][2]) afin qu'un madd 16 bits accumule deux
+// termes du patch pour plusieurs pixels de sortie à la fois, en int32.
+static void qconv_forward(const QConvLayer *layer, const uint8_t *input,
+                          int16_t *cols, int32_t *acc, uint8_t *output) {
+    const SimdKernels *k = simd_kernels();
+    int in_w = layer->input_width;
+    int in_plane = layer->input_width * layer->input_height;
+    int out_w = layer->output_width;
+    int out_h = layer->output_height;
+    int out_plane = out_w * out_h;
+    int f_size = layer->filter_size;
+    int f_area = f_size * f_size;
+    int patch = layer->input_channels * f_area;
+    int pairs = qconv_pairs(layer);
+    float inv_out_scale = 1.0f / layer->output_scale;
+
+    for (int q = 0; q < pairs; q++) {
+        int16_t *dst = cols + q * out_plane * 2;
+        int p0 = 2 * q;
+        int p1 = 2 * q + 1;
+        const uint8_t *src0 = input + (p0 / f_area) * in_plane +
+                              ((p0 % f_area) / f_size) * in_w + p0 % f_size;
+        const uint8_t *src1 = (p1 < patch)
+                              ? input + (p1 / f_area) * in_plane +
+                                ((p1 % f_area) / f_size) * in_w + p1 % f_size
+                              : NULL;
+
+        for (int y = 0; y < out_h; y++) {
+            const uint8_t *row0 = src0 + y * in_w;
+            int16_t *d = dst + 2 * y * out_w;
+
+            if (src1) {
+                const uint8_t *row1 = src1 + y * in_w;
+                for (int x = 0; x < out_w; x++) {
+                    d[2 * x] = row0[x];
+                    d[2 * x + 1] = row1[x];
+                }
+            } else {
+                for (int x = 0; x < out_w; x++) {
+                    d[2 * x] = row0[x];
+                    d[2 * x + 1] = 0;
+                }
+            }
+        }
+    }
+
+    for (int f = 0; f < layer->num_filters; f++) {
+        const int8_t *w = layer->weights + f * patch;
+        memset(acc, 0, out_plane * sizeof(int32_t));
+
+        for (int q = 0; q < pairs; q++) {
+            uint16_t w0 = (uint16_t)(int16_t)w[2 * q];
+            uint16_t w1 = (2 * q + 1 < patch) ? (uint16_t)(int16_t)w[2 * q + 1] : 0;
+            int32_t w_pair = (int32_t)(((uint32_t)w1 << 16) | w0);
+
+            k->madd_s16_pairs(cols + q * out_plane * 2, w_pair, acc, out_plane);
+        }
+
+        float scale = layer->requant[f] * inv_out_scale;
+        float offset = layer->biases[f] * inv_out_scale;
+        uint8_t *out = output + f * out_plane;
+        for (int j = 0; j < out_plane; j++) {
+            out[j] = requantize_relu(acc[j], scale, offset);
+        }
+    }
+}
+
+// Max pooling sur uint8 (la quantification est monotone: max et arrondi commutent)
+static void qpool_forward(const uint8_t *input, int channels, int in_w, int in_h,
+                          int p_size, uint8_t *output) {
+    int out_w = in_w / p_size;
+    int out_h = in_h / p_size;
+
+    for (int c = 0; c < channels; c++) {
+        const uint8_t *in = input + c * in_w * in_h;
+        uint8_t *out = output + c * out_w * out_h;
+
+        for (int y = 0; y < out_h; y++) {
+            for (int x = 0; x < out_w; x++) {
+                uint8_t m = 0;
+                for (int py = 0; py < p_size; py++) {
+                    for (int px = 0; px < p_size; px++) {
+                        uint8_t v = in[(y * p_size + py) * in_w + x * p_size + px];
+                        if (v > m) m = v;
+                    }
+                }
+                out[y * out_w + x] = m;
+            }
+        }
+    }
+}
+
+// Couche dense int8. Si output_scale > 0: sortie uint8 après ReLU dans out_q,
+// sinon logits float dans out_f.
+static void qdense_forward(const QDenseLayer *layer, const uint8_t *input,
+                           uint8_t *out_q, float *out_f) {
+    const SimdKernels *k = simd_kernels();
+
+    for (int i = 0; i < layer->output_size; i++) {
+        int32_t acc = k->dot_u8s8(input, layer->weights + i * layer->input_size, layer->input_size);
+
+        if (layer->output_scale > 0.0f) {
+            float inv_out_scale = 1.0f / layer->output_scale;
+            out_q[i] = requantize_relu(acc, layer->requant[i] * inv_out_scale,
+                                       layer->biases[i] * inv_out_scale);
+        } else {
+            out_f[i] = (float)acc * layer->requant[i] + layer->biases[i];
+        }
+    }
+}
+
+void cnn_forward_q8(const QuantizedCNNModel *qmodel, const float *input, float *probs_out) {
+    const QConvLayer *conv1 = &qmodel->conv1;
+    const QConvLayer *conv2 = &qmodel->conv2;
+
+    int in_size = conv1->input_channels * conv1->input_width * conv1->input_height;
+    int conv1_plane = conv1->output_width * conv1->output_height;
+    int conv2_plane = conv2->output_width * conv2->output_height;
+    int conv1_cols = qconv_pairs(conv1) * 2 * conv1_plane;
+    int conv2_cols = qconv_pairs(conv2) * 2 * conv2_plane;
+    int pool1_size = conv2->input_channels * conv2->input_width * conv2->input_height;
+
+    // Tampons sur la pile (~40 Ko pour l'architecture LeNet)
+    uint8_t in_q[in_size];
+    uint8_t conv1_out[conv1->num_filters * conv1_plane];
+    uint8_t pool1_out[pool1_size];
+    uint8_t conv2_out[conv2->num_filters * conv2_plane];
+    uint8_t pool2_out[qmodel->fc1.input_size];
+    uint8_t fc1_out[qmodel->fc1.output_size];
+    float logits[qmodel->fc2.output_size];
+    int16_t cols[max_int(conv1_cols, conv2_cols)];
+    int32_t acc[max_int(conv1_plane, conv2_plane)];
+
+    // Entrée [0,1] -> uint8 (exacte pour des images 8 bits normalisées)
+    float inv_in = 1.0f / qmodel->input_scale;
+    for (int i = 0; i < in_size; i++) {
+        float v = input[i] * inv_in + 0.5f;
+        v = (v < 0.0f) ? 0.0f : v;
+        v = (v > 255.0f) ? 255.0f : v;
+        in_q[i] = (uint8_t)v;
+    }
+
+    qconv_forward(conv1, in_q, cols, acc, conv1_out);
+    qpool_forward(conv1_out, conv1->num_filters, conv1->output_width, conv1->output_height,
+                  qmodel->pool1_size, pool1_out);
+    qconv_forward(conv2, pool1_out, cols, acc, conv2_out);
+    qpool_forward(conv2_out, conv2->num_filters, conv2->output_width, conv2->output_height,
+                  qmodel->pool2_size, pool2_out);
+    qdense_forward(&qmodel->fc1, pool2_out, fc1_out, NULL);
+    qdense_forward(&qmodel->fc2, fc1_out, NULL, logits);
+
+    simd_kernels()->softmax(logits, probs_out, qmodel->fc2.output_size);
+}
+
+int cnn_predict_q8(const QuantizedCNNModel *qmodel, const float *input) {
+    float probs[qmodel->fc2.output_size];
+    cnn_forward_q8(qmodel, input, probs);
+
+    int predicted_class = 0;
+    for (int i = 1; i < qmodel->fc2.output_size; i++) {
+        if (probs[i] > probs[predicted_class]) predicted_class = i;
+    }
+    return predicted_class;
+}
@@ -0,0 +1,75 @@
+#ifndef CNN_QUANTIZED_H
+#define CNN_QUANTIZED_H
+
+#include "cnn_model.h"
+#include <stdint.h>
+
+// ============================================================================
+// MODÈLE CNN QUANTIFIÉ INT8 (POST-TRAINING)
+// ============================================================================
+//
+// Même architecture que create_cnn_model(). Les poids sont quantifiés en int8
+// symétrique par canal de sortie (un facteur d'échelle par filtre / neurone),
+// les activations (positives après ReLU) en uint8 avec un facteur par tenseur
+// calibré sur un échantillon d'images. Les produits sont accumulés en int32
+// puis remis à l'échelle en float pour le biais et la ReLU.
+
+// Couche de convolution quantifiée
+typedef struct {
+    int num_filters;
+    int filter_size;
+    int input_channels;
+    int input_width;
+    int input_height;
+    int output_width;
+    int output_height;
+
+    int8_t *weights;        // [filtre][canal][fy][fx]
+    float *biases;          // Biais float (ajoutés après remise à l'échelle)
+    float *requant;         // Par filtre: échelle entrée * échelle poids
+    float output_scale;     // Échelle uint8 de la sortie (après ReLU)
+} QConvLayer;
+
+// Couche dense quantifiée
+typedef struct {
+    int input_size;
+    int output_size;
+
+    int8_t *weights;        // [sortie][entrée]
+    float *biases;
+    float *requant;         // Par neurone: échelle entrée * échelle poids
+    float output_scale;     // Échelle uint8 de la sortie (0 pour la couche de sortie)
+} QDenseLayer;
+
+typedef struct {
+    float input_scale;      // 1/255: les images normalisées [0,1] sont exactes en uint8
+
+    QConvLayer conv1;
+    int pool1_size;
+    QConvLayer conv2;
+    int pool2_size;
+    QDenseLayer fc1;
+    QDenseLayer fc2;        // Sortie: logits float
+} QuantizedCNNModel;
+
+// ============================================================================
+// QUANTIFICATION ET INFÉRENCE
+// ============================================================================
+
+// Quantifie un modèle float entraîné
+// calib_images: images 28x28 normalisées (ex: dataset->images d'un MNISTDataset)
+// calib_count: nombre d'images utilisées pour calibrer les activations
+QuantizedCNNModel* quantize_cnn_model(const CNNModel *model,
+                                      float * const *calib_images, int calib_count);
+
+void free_quantized_model(QuantizedCNNModel *qmodel);
+
+// Forward pass int8 d'une image 28x28 normalisée [0,1]
+// Réentrant, sans allocation dynamique (tampons sur la pile)
+// probs_out: 10 probabilités softmax
+void cnn_forward_q8(const QuantizedCNNModel *qmodel, const float *input, float *probs_out);
+
+// Prédiction int8 (retourne la classe 0-9)
+int cnn_predict_q8(const QuantizedCNNModel *qmodel, const float *input);
+
+#endif // CNN_QUANTIZED_H
@@ -0,0 +1,233 @@
+#define _POSIX_C_SOURCE 200809L  // sysconf
+
+#include "connected_components.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Segments d'une bande [y_begin, y_end) et leur forêt union-find (indices
+// locaux à la bande; parent[i] <= i)
+typedef struct {
+    const GrayImage *img;
+    uint8_t threshold;
+    int y_begin;
+    int y_end;
+    ComponentRun *runs;
+    int *parent;
+    int count;
+    int capacity;
+    bool ok;
+} StripRuns;
+
+static int find_root(int *parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];  // Compression par moitié
+        i = parent[i];
+    }
+    return i;
+}
+
+// Unit deux ensembles: la racine la plus récente pointe vers la plus ancienne
+static void union_runs(int *parent, int a, int b) {
+    a = find_root(parent, a);
+    b = find_root(parent, b);
+    if (a < b) parent[b] = a;
+    else if (b < a) parent[a] = b;
+}
+
+// Unit les segments [cur, cur_end) d'une ligne à ceux de la ligne précédente
+// [prev, prev_end) qu'ils chevauchent (même colonne: 4-connexité)
+static void union_rows(const ComponentRun *runs, int *parent, int prev, int prev_end,
+                       int cur, int cur_end) {
+    for (int r = cur; r < cur_end; r++) {
+        while (prev < prev_end && runs[prev].x_end <= runs[r].x_begin) prev++;
+        for (int p = prev; p < prev_end && runs[p].x_begin < runs[r].x_end; p++) {
+            union_runs(parent, r, p);
+        }
+    }
+}
+
+static bool strip_push(StripRuns *strip, int y, int x_begin, int x_end) {
+    if (strip->count == strip->capacity) {
+        int capacity = strip->capacity ? 2 * strip->capacity : 1024;
+        ComponentRun *runs = (ComponentRun*)realloc(strip->runs, capacity * sizeof(ComponentRun));
+        if (!runs) return false;
+        strip->runs = runs;
+        int *parent = (int*)realloc(strip->parent, capacity * sizeof(int));
+        if (!parent) return false;
+        strip->parent = parent;
+        strip->capacity = capacity;
+    }
+    int i = strip->count++;
+    strip->runs[i] = (ComponentRun){y, x_begin, x_end, 0};
+    strip->parent[i] = i;
+    return true;
+}
+
+// Première passe sur une bande: segments ligne par ligne, unis à la ligne
+// précédente de la bande
+static void* label_strip(void *arg) {
+    StripRuns *strip = (StripRuns*)arg;
+    int width = (int)strip->img->width;
+    int prev_begin = 0;
+    int prev_end = 0;
+    strip->ok = true;
+
+    for (int y = strip->y_begin; y < strip->y_end; y++) {
+        const uint8_t *row = strip->img->data + (size_t)y * width;
+        int row_begin = strip->count;
+        int x = 0;
+        while (x < width) {
+            while (x < width && row[x] <= strip->threshold) x++;
+            if (x == width) break;
+            int x_begin = x;
+            while (x < width && row[x] > strip->threshold) x++;
+            if (!strip_push(strip, y, x_begin, x)) {
+                strip->ok = false;
+                return NULL;
+            }
+        }
+        union_rows(strip->runs, strip->parent, prev_begin, prev_end, row_begin, strip->count);
+        prev_begin = row_begin;
+        prev_end = strip->count;
+    }
+    return NULL;
+}
+
+// Seconde passe: composante de chaque segment (celle de son parent, déjà
+// traité puisque parent[i] <= i) et statistiques
+static bool resolve_components(ComponentLabels *labels, int *parent) {
+    labels->components = (ComponentStats*)malloc((labels->num_runs ? labels->num_runs : 1) *
+                                                 sizeof(ComponentStats));
+    if (!labels->components) return false;
+
+    for (int i = 0; i < labels->num_runs; i++) {
+        ComponentRun *run = &labels->runs[i];
+        ComponentStats *stats;
+        if (parent[i] == i) {
+            run->component = labels->num_components++;
+            stats = &labels->components[run->component];
+            *stats = (ComponentStats){0, run->x_begin, run->y, run->x_end - 1, run->y, i};
+        } else {
+            run->component = labels->runs[parent[i]].component;
+            stats = &labels->components[run->component];
+            if (run->x_begin < stats->min_x) stats->min_x = run->x_begin;
+            if (run->x_end - 1 > stats->max_x) stats->max_x = run->x_end - 1;
+            if (run->y > stats->max_y) stats->max_y = run->y;
+        }
+        stats->area += run->x_end - run->x_begin;
+    }
+    return true;
+}
+
+bool label_components(const GrayImage *img, uint8_t threshold, int num_threads,
+                      ComponentLabels *labels) {
+    memset(labels, 0, sizeof(ComponentLabels));
+    int height = (int)img->height;
+
+    if (num_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = (cpus > 0) ? (int)cpus : 1;
+    }
+    size_t pixels = img->width * img->height;
+    int num_strips = (int)(pixels / CCL_MIN_STRIP_PIXELS);
+    if (num_strips > num_threads) num_strips = num_threads;
+    if (num_strips > height) num_strips = height;
+    if (num_strips < 1) num_strips = 1;
+
+    StripRuns strips[num_strips];
+    memset(strips, 0, sizeof(strips));
+    for (int s = 0; s < num_strips; s++) {
+        strips[s].img = img;
+        strips[s].threshold = threshold;
+        strips[s].y_begin = (int)((int64_t)height * s / num_strips);
+        strips[s].y_end = (int)((int64_t)height * (s + 1) / num_strips);
+    }
+
+    // Une bande par thread, le thread appelant prend la première
+    pthread_t threads[num_strips];
+    bool started[num_strips];
+    for (int s = 1; s < num_strips; s++) {
+        started[s] = pthread_create(&threads[s], NULL, label_strip, &strips[s]) == 0;
+        if (!started[s]) label_strip(&strips[s]);
+    }
+    label_strip(&strips[0]);
+    bool ok = strips[0].ok;
+    for (int s = 1; s < num_strips; s++) {
+        if (started[s]) pthread_join(threads[s], NULL);
+        ok = ok && strips[s].ok;
+    }
+
+    int *parent = NULL;
+    if (ok && num_strips == 1) {
+        // Bande unique: les tableaux de la bande servent directement
+        labels->runs = strips[0].runs;
+        labels->num_runs = strips[0].count;
+        parent = strips[0].parent;
+        strips[0].runs = NULL;
+        strips[0].parent = NULL;
+    } else if (ok) {
+        // Concaténation (indices décalés), puis union des lignes de jonction
+        int total = 0;
+        for (int s = 0; s < num_strips; s++) total += strips[s].count;
+        labels->runs = (ComponentRun*)malloc((total ? total : 1) * sizeof(ComponentRun));
+        parent = (int*)malloc((total ? total : 1) * sizeof(int));
+        ok = labels->runs && parent;
+
+        int offset = 0;
+        int prev_begin = 0;  // Segments de la dernière ligne de la bande précédente
+        int prev_end = 0;
+        for (int s = 0; ok && s < num_strips; s++) {
+            StripRuns *strip = &strips[s];
+            if (strip->count > 0) {
+                memcpy(labels->runs + offset, strip->runs, strip->count * sizeof(ComponentRun));
+            }
+            for (int i = 0; i < strip->count; i++) parent[offset + i] = strip->parent[i] + offset;
+
+            int first_end = offset;
+            while (first_end < offset + strip->count && labels->runs[first_end].y == strip->y_begin) {
+                first_end++;
+            }
+            union_rows(labels->runs, parent, prev_begin, prev_end, offset, first_end);
+
+            // Segments de la dernière ligne de la bande (aucun si elle est vide)
+            int last_begin = offset + strip->count;
+            while (last_begin > offset && labels->runs[last_begin - 1].y == strip->y_end - 1) {
+                last_begin--;
+            }
+            prev_begin = last_begin;
+            prev_end = offset + strip->count;
+            offset += strip->count;
+        }
+        labels->num_runs = total;
+    }
+
+    for (int s = 0; s < num_strips; s++) {
+        free(strips[s].runs);
+        free(strips[s].parent);
+    }
+
+    ok = ok && resolve_components(labels, parent);
+    free(parent);
+    if (!ok) {
+        LOG_ERROR("Allocation impossible (composantes connexes)");
+        component_labels_free(labels);
+    }
+    return ok;
+}
+
+void component_labels_free(ComponentLabels *labels) {
+    free(labels->runs);
+    free(labels->components);
+    memset(labels, 0, sizeof(ComponentLabels));
+}
+
+int largest_component(const ComponentLabels *labels) {
+    int best = -1;
+    for (int c = 0; c < labels->num_components; c++) {
+        if (best < 0 || labels->components[c].area > labels->components[best].area) best = c;
+    }
+    return best;
+}
@@ -0,0 +1,66 @@
+#ifndef CONNECTED_COMPONENTS_H
+#define CONNECTED_COMPONENTS_H
+
+#include "utils.h"
+
+// ============================================================================
+// COMPOSANTES CONNEXES (UNION-FIND SUR SEGMENTS)
+// ============================================================================
+//
+// Étiquetage en deux passes sur des segments horizontaux (runs) plutôt que
+// sur des pixels: la première passe découpe chaque ligne en segments
+// d'avant-plan et unit (union-find) chaque segment à ceux de la ligne
+// précédente qu'il chevauche (4-connexité); la seconde parcourt les segments
+// dans l'ordre et donne à chacun la composante de son parent, en cumulant aire
+// et boîte englobante. Pas de carte d'étiquettes par pixel ni de pile: la
+// mémoire est proportionnelle au nombre de segments.
+// Les unions rattachent toujours la racine la plus récente à la plus ancienne:
+// les composantes sont numérotées dans l'ordre de balayage de leur premier
+// pixel, comme un remplissage lancé ligne par ligne.
+//
+// Variante parallèle: l'image est découpée en bandes de lignes étiquetées
+// indépendamment, puis les segments des lignes de jonction sont unis. Elle ne
+// sert qu'aux appels directs sur de grandes images: le pipeline détecte la
+// grille sur une copie réduite (grand côté < 1.5 * PYRAMID_DETECT_SIDE, soit
+// moins de 1.5 Mpixels), toujours étiquetée en une seule bande.
+
+#define CCL_MIN_STRIP_PIXELS (1 << 20)  // Pixels par bande au moins (parallèle)
+
+// Segment d'avant-plan [x_begin, x_end) de la ligne y
+typedef struct {
+    int y;
+    int x_begin;
+    int x_end;
+    int component;              // Composante du segment
+} ComponentRun;
+
+typedef struct {
+    int area;                   // Nombre de pixels
+    int min_x, min_y;           // Boîte englobante (bornes incluses)
+    int max_x, max_y;
+    int first_run;              // Premier segment de la composante
+} ComponentStats;
+
+typedef struct {
+    ComponentRun *runs;         // Segments dans l'ordre de balayage
+    int num_runs;
+    ComponentStats *components; // Dans l'ordre de balayage du premier pixel
+    int num_components;
+} ComponentLabels;
+
+// Étiquette les pixels > threshold (4-connexité)
+// num_threads: <= 0 pour un thread par CPU; une seule bande sous
+//              2 * CCL_MIN_STRIP_PIXELS pixels
+// Returns: false si une allocation échoue (labels remis à zéro)
+bool label_components(const GrayImage *img, uint8_t threshold, int num_threads,
+                      ComponentLabels *labels);
+
+// Libère les segments et composantes
+void component_labels_free(ComponentLabels *labels);
+
+// Composante de plus grande aire, la première dans l'ordre de balayage en cas
+// d'égalité
+// Returns: son indice, -1 si l'image n'a aucun pixel d'avant-plan
+int largest_component(const ComponentLabels *labels);
+
+#endif // CONNECTED_COMPONENTS_H
@@ -1,7 +1,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "cnn_model.h"
+#include "cnn_quantized.h"
 #include "dataset_loader.h"
 #include "utils.h"
 
@@ -79,6 +81,96 @@ void print_metrics(int matrix[10][10]) {
     printf("\nF1-Score Moyen: %.1f%%\n", (total_f1 / classes_count) * 100);
 }
 
+// Compare le modèle int8 au modèle float: précision par classe, accord, vitesse
+void evaluate_quantized(CNNModel *model, MNISTDataset *dataset) {
+    printf("\n==================================================\n");
+    printf("QUANTIFICATION INT8\n");
+    printf("==================================================\n");
+
+    // Calibration sur une tranche du jeu d'entraînement (sinon sur le jeu de test)
+    const int calib_count = 1000;
+    MNISTDataset *calib = load_mnist_dataset("data/mnist/train-images.idx3-ubyte",
+                                             "data/mnist/train-labels.idx1-ubyte");
+    float **calib_images = calib ? calib->images : dataset->images;
+    int calib_available = calib ? (int)calib->count : (int)dataset->count;
+    if (!calib) {
+        LOG_INFO("MNIST train introuvable, calibration sur le jeu de test (biais optimiste)");
+    }
+
+    QuantizedCNNModel *qmodel = quantize_cnn_model(model, calib_images,
+                                                   min_int(calib_count, calib_available));
+    if (calib) free_mnist_dataset(calib);
+    if (!qmodel) {
+        LOG_ERROR("Quantification impossible.");
+        return;
+    }
+
+    InferenceContext *ctx = create_inference_context(model, 1);
+    if (!ctx) {
+        free_quantized_model(qmodel);
+        return;
+    }
+
+    int correct_float[10] = {0};
+    int correct_q8[10] = {0};
+    int totals[10] = {0};
+    int agree = 0;
+    float probs[10];
+    double float_time = 0.0, q8_time = 0.0;
+
+    for (size_t i = 0; i < dataset->count; i++) {
+        int actual = dataset->labels[i];
+
+        clock_t t0 = clock();
+        cnn_forward_ctx(model, ctx, dataset->images[i], 1, probs);
+        clock_t t1 = clock();
+        int pred_float = 0;
+        for (int c = 1; c < 10; c++) {
+            if (probs[c] > probs[pred_float]) pred_float = c;
+        }
+
+        clock_t t2 = clock();
+        int pred_q8 = cnn_predict_q8(qmodel, dataset->images[i]);
+        clock_t t3 = clock();
+
+        float_time += (double)(t1 - t0) / CLOCKS_PER_SEC;
+        q8_time += (double)(t3 - t2) / CLOCKS_PER_SEC;
+
+        totals[actual]++;
+        if (pred_float == actual) correct_float[actual]++;
+        if (pred_q8 == actual) correct_q8[actual]++;
+        if (pred_float == pred_q8) agree++;
+    }
+
+    int total_float = 0, total_q8 = 0;
+    printf("Classe | Float     | Int8      | Écart\n");
+    printf("-------|-----------|-----------|----------\n");
+    for (int c = 0; c < 10; c++) {
+        total_float += correct_float[c];
+        total_q8 += correct_q8[c];
+        if (totals[c] == 0) continue;
+
+        float acc_float = (float)correct_float[c] / totals[c] * 100.0f;
+        float acc_q8 = (float)correct_q8[c] / totals[c] * 100.0f;
+        char label_name[10];
+        if (c == 0) snprintf(label_name, 10, "Vide");
+        else snprintf(label_name, 10, "%d   ", c);
+
+        printf("   %s   |   %5.1f%%  |   %5.1f%%  |  %+5.2f%%\n",
+               label_name, acc_float, acc_q8, acc_q8 - acc_float);
+    }
+
+    printf("\nPrécision float: %.2f%%\n", (float)total_float / dataset->count * 100.0f);
+    printf("Précision int8:  %.2f%%\n", (float)total_q8 / dataset->count * 100.0f);
+    printf("Accord float/int8: %.2f%%\n", (float)agree / dataset->count * 100.0f);
+    printf("Temps par image: float %.1f us, int8 %.1f us (x%.2f)\n",
+           float_time / dataset->count * 1e6, q8_time / dataset->count * 1e6,
+           q8_time > 0.0 ? float_time / q8_time : 0.0);
+
+    free_inference_context(ctx);
+    free_quantized_model(qmodel);
+}
+
 int main() {
     // 1. Charger les données de test MNIST
     LOG_INFO("Chargement des données de test MNIST...");
@@ -153,6 +245,8 @@ int main() {
     print_confusion_matrix(confusion_matrix);
     print_metrics(confusion_matrix);
     
+    evaluate_quantized(model, dataset);
+    
     // Cleanup
     free_cnn_model(model);
     free_mnist_dataset(dataset);
@@ -1,9 +1,12 @@
 #include "grid_detector.h"
+#include "connected_components.h"
+#include "hough_fast.h"
 #include <math.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <float.h>
+#include <limits.h>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -131,193 +134,273 @@ HoughLine* hough_lines(const GrayImage *edges, int threshold, int *num_lines) {
 // BLOB DETECTION (CONNECTED COMPONENTS)
 // ============================================================================
 
-// Simple stack-based flood fill to find connected components
-// Returns the area of the component
-static int flood_fill(int *labels, int width, int height, int x, int y, int label, 
-                      int *min_x, int *max_x, int *min_y, int *max_y) {
-    if (x < 0 || x >= width || y < 0 || y >= height) return 0;
-    if (labels[y * width + x] != -1) return 0; // Already visited or background
-    
-    // Stack for recursion simulation
-    int capacity = 10000;
-    int *stack_x = (int*)malloc(capacity * sizeof(int));
-    int *stack_y = (int*)malloc(capacity * sizeof(int));
-    int top = 0;
-    
-    stack_x[top] = x;
-    stack_y[top] = y;
-    top++;
-    
-    int area = 0;
-    *min_x = width; *max_x = 0;
-    *min_y = height; *max_y = 0;
-    
-    while (top > 0) {
-        top--;
-        int cx = stack_x[top];
-        int cy = stack_y[top];
-        
-        if (cx < 0 || cx >= width || cy < 0 || cy >= height) continue;
-        if (labels[cy * width + cx] != -1) continue;
-        
-        labels[cy * width + cx] = label;
-        area++;
-        
-        if (cx < *min_x) *min_x = cx;
-        if (cx > *max_x) *max_x = cx;
-        if (cy < *min_y) *min_y = cy;
-        if (cy > *max_y) *max_y = cy;
-        
-        // Check neighbors (4-connectivity)
-        if (top + 4 >= capacity) {
-            capacity *= 2;
-            stack_x = (int*)realloc(stack_x, capacity * sizeof(int));
-            stack_y = (int*)realloc(stack_y, capacity * sizeof(int));
-        }
-        
-        // Push neighbors if they are foreground (-1 means foreground not visited, 0 means background)
-        // Wait, we need to know which pixels are foreground.
-        // The labels array should be initialized: 0 for background, -1 for foreground.
-        
-        // Right
-        if (cx + 1 < width && labels[cy * width + (cx + 1)] == -1) {
-            stack_x[top] = cx + 1; stack_y[top] = cy; top++;
-        }
-        // Left
-        if (cx - 1 >= 0 && labels[cy * width + (cx - 1)] == -1) {
-            stack_x[top] = cx - 1; stack_y[top] = cy; top++;
-        }
-        // Down
-        if (cy + 1 < height && labels[(cy + 1) * width + cx] == -1) {
-            stack_x[top] = cx; stack_y[top] = cy + 1; top++;
-        }
-        // Up
-        if (cy - 1 >= 0 && labels[(cy - 1) * width + cx] == -1) {
-            stack_x[top] = cx; stack_y[top] = cy - 1; top++;
-        }
+// Find corners of a component from its runs
+// We look for the pixels that maximize/minimize x+y and y-x: within a run they
+// are its end pixels, and runs come in scan order, so ties keep the first
+// pixel in scan order
+static void find_blob_corners(const ComponentLabels *labels, int component, Quad *quad) {
+    Point2D tl = {0, 0}, tr = {0, 0}, br = {0, 0}, bl = {0, 0};
+
+    float min_sum = FLT_MAX, max_sum = -FLT_MAX;
+    float min_diff = FLT_MAX, max_diff = -FLT_MAX;
+
+    for (int i = labels->components[component].first_run; i < labels->num_runs; i++) {
+        const ComponentRun *run = &labels->runs[i];
+        if (run->component != component) continue;
+        int y = run->y;
+        int first = run->x_begin;
+        int last = run->x_end - 1;
+
+        if (first + y < min_sum) { min_sum = first + y; tl = (Point2D){first, y}; }
+        if (last + y > max_sum) { max_sum = last + y; br = (Point2D){last, y}; }
+        if (y - last < min_diff) { min_diff = y - last; tr = (Point2D){last, y}; }
+        if (y - first > max_diff) { max_diff = y - first; bl = (Point2D){first, y}; }
     }
-    
-    free(stack_x);
-    free(stack_y);
-    return area;
+
+    quad->corners[0] = tl;
+    quad->corners[1] = tr;
+    quad->corners[2] = br;
+    quad->corners[3] = bl;
 }
 
-// Find the largest connected component in the binary image
-// Returns a mask where the largest component is 255, others 0
-// Also returns the bounding box of the component
-static GrayImage* find_largest_blob(const GrayImage *binary, int *bbox_x, int *bbox_y, int *bbox_w, int *bbox_h) {
-    int w = binary->width;
-    int h = binary->height;
-    
-    // Initialize labels: 0 for background, -1 for foreground
-    int *labels = (int*)malloc(w * h * sizeof(int));
-    for (int i = 0; i < w * h; i++) {
-        labels[i] = (binary->data[i] > 128) ? -1 : 0;
-    }
-    
-    int max_area = 0;
-    int best_label = 0;
-    int current_label = 1;
-    
-    int best_min_x = 0, best_max_x = 0, best_min_y = 0, best_max_y = 0;
-    
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            if (labels[y * w + x] == -1) {
-                int min_x, max_x, min_y, max_y;
-                int area = flood_fill(labels, w, h, x, y, current_label, &min_x, &max_x, &min_y, &max_y);
-                
-                if (area > max_area) {
-                    max_area = area;
-                    best_label = current_label;
-                    best_min_x = min_x;
-                    best_max_x = max_x;
-                    best_min_y = min_y;
-                    best_max_y = max_y;
+// ============================================================================
+// QUAD DETECTION
+// ============================================================================
+
+// Contraste minimal (max - min) d'une fenêtre de recalage
+#define REFINE_MIN_CONTRAST 32
+
+void refine_quad_corners(const GrayImage *gray, Quad *quad, int radius) {
+    // Direction de chaque coin: score = sx * x + sy * y à maximiser
+    static const int sx[4] = {-1, 1, 1, -1};
+    static const int sy[4] = {-1, -1, 1, 1};
+    int width = (int)gray->width;
+    int height = (int)gray->height;
+
+    for (int i = 0; i < 4; i++) {
+        int cx = (int)lroundf(quad->corners[i].x);
+        int cy = (int)lroundf(quad->corners[i].y);
+        int x0 = (cx - radius > 0) ? cx - radius : 0;
+        int y0 = (cy - radius > 0) ? cy - radius : 0;
+        int x1 = (cx + radius < width - 1) ? cx + radius : width - 1;
+        int y1 = (cy + radius < height - 1) ? cy + radius : height - 1;
+        if (x0 > x1 || y0 > y1) continue;
+
+        uint8_t lo = 255, hi = 0;
+        for (int y = y0; y <= y1; y++) {
+            const uint8_t *row = gray->data + (size_t)y * width;
+            for (int x = x0; x <= x1; x++) {
+                if (row[x] < lo) lo = row[x];
+                if (row[x] > hi) hi = row[x];
+            }
+        }
+        if (hi - lo < REFINE_MIN_CONTRAST) continue;
+
+        int mid = (lo + hi) / 2;
+        int best = INT_MIN;
+        for (int y = y0; y <= y1; y++) {
+            const uint8_t *row = gray->data + (size_t)y * width;
+            for (int x = x0; x <= x1; x++) {
+                int score = sx[i] * x + sy[i] * y;
+                if (row[x] < mid && score > best) {
+                    best = score;
+                    quad->corners[i] = (Point2D){x, y};
                 }
-                current_label++;
             }
         }
     }
-    
-    // Create output mask
-    GrayImage *mask = gray_image_create(w, h);
-    for (int i = 0; i < w * h; i++) {
-        mask->data[i] = (labels[i] == best_label) ? 255 : 0;
+}
+
+// Ajustement des bords: échantillons par bord, contraste minimal d'une
+// transition, points minimaux par droite
+#define SUBPIXEL_MAX_SAMPLES  512
+#define SUBPIXEL_MIN_CONTRAST 24.0f
+#define SUBPIXEL_MIN_POINTS   8
+
+typedef struct {
+    float nx, ny;               // Normale unitaire
+    float c;                    // nx * x + ny * y = c
+} EdgeLine;
+
+// Niveau de gris interpolé en (x, y), qui doit être dans [0, w-1] x [0, h-1]
+static float sample_bilinear(const GrayImage *gray, float x, float y) {
+    int x0 = (int)x;
+    int y0 = (int)y;
+    int x1 = (x0 + 1 < (int)gray->width) ? x0 + 1 : x0;
+    int y1 = (y0 + 1 < (int)gray->height) ? y0 + 1 : y0;
+    float dx = x - x0;
+    float dy = y - y0;
+    const uint8_t *row0 = gray->data + (size_t)y0 * gray->width;
+    const uint8_t *row1 = gray->data + (size_t)y1 * gray->width;
+    float top = row0[x0] + (row0[x1] - row0[x0]) * dx;
+    float bottom = row1[x0] + (row1[x1] - row1[x0]) * dx;
+    return top + (bottom - top) * dy;
+}
+
+// Droite des moindres carrés orthogonaux (axe principal) des points retenus
+static bool fit_line(const Point2D *points, const bool *keep, int count, EdgeLine *line) {
+    double mx = 0, my = 0;
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        if (!keep[i]) continue;
+        mx += points[i].x;
+        my += points[i].y;
+        n++;
     }
-    
-    free(labels);
-    
-    if (bbox_x) *bbox_x = best_min_x;
-    if (bbox_y) *bbox_y = best_min_y;
-    if (bbox_w) *bbox_w = best_max_x - best_min_x + 1;
-    if (bbox_h) *bbox_h = best_max_y - best_min_y + 1;
-    
-    return mask;
+    if (n < SUBPIXEL_MIN_POINTS) return false;
+    mx /= n;
+    my /= n;
+
+    double sxx = 0, syy = 0, sxy = 0;
+    for (int i = 0; i < count; i++) {
+        if (!keep[i]) continue;
+        double dx = points[i].x - mx;
+        double dy = points[i].y - my;
+        sxx += dx * dx;
+        syy += dy * dy;
+        sxy += dx * dy;
+    }
+    // Direction de plus grande variance, normale perpendiculaire
+    double angle = 0.5 * atan2(2.0 * sxy, sxx - syy);
+    line->nx = (float)-sin(angle);
+    line->ny = (float)cos(angle);
+    line->c = (float)(line->nx * mx + line->ny * my);
+    return true;
 }
 
-// Find corners of the blob
-// We scan the blob to find pixels that maximize/minimize x+y and x-y
-static void find_blob_corners(const GrayImage *blob, Quad *quad) {
-    int w = blob->width;
-    int h = blob->height;
-    
-    // Initialize with center to be safe
-    Point2D tl = {w/2, h/2}, tr = {w/2, h/2}, br = {w/2, h/2}, bl = {w/2, h/2};
-    
-    float min_sum = FLT_MAX, max_sum = -FLT_MAX;
-    float min_diff = FLT_MAX, max_diff = -FLT_MAX;
-    
-    for (int y = 0; y < h; y++) {
-        for (int x = 0; x < w; x++) {
-            if (blob->data[y * w + x] > 128) {
-                float sum = x + y;
-                float diff = y - x;
-                
-                if (sum < min_sum) { min_sum = sum; tl = (Point2D){x, y}; }
-                if (sum > max_sum) { max_sum = sum; br = (Point2D){x, y}; }
-                if (diff < min_diff) { min_diff = diff; tr = (Point2D){x, y}; }
-                if (diff > max_diff) { max_diff = diff; bl = (Point2D){x, y}; }
+// Points de bord le long du côté a -> b (intérieur à droite en repère image)
+// Returns: nombre de points écrits dans points
+static int sample_edge_points(const GrayImage *gray, Point2D a, Point2D b, int band,
+                              Point2D *points) {
+    float length = hypotf(b.x - a.x, b.y - a.y);
+    if (length < 1.0f) return 0;
+    float ux = (b.x - a.x) / length;
+    float uy = (b.y - a.y) / length;
+    float nx = uy;                      // Normale sortante
+    float ny = -ux;
+
+    int samples = (int)(0.8f * length);
+    if (samples > SUBPIXEL_MAX_SAMPLES) samples = SUBPIXEL_MAX_SAMPLES;
+    float max_x = (float)gray->width - 1;
+    float max_y = (float)gray->height - 1;
+    float profile[2 * band + 3];
+    int count = 0;
+
+    for (int k = 0; k < samples; k++) {
+        float t = 0.1f + 0.8f * (k + 0.5f) / samples;
+        float px = a.x + (b.x - a.x) * t;
+        float py = a.y + (b.y - a.y) * t;
+
+        // Profil sur [-band - 1, band + 1], entièrement dans l'image
+        bool inside = true;
+        for (int s = 0; inside && s < 2 * band + 3; s++) {
+            float x = px + (s - band - 1) * nx;
+            float y = py + (s - band - 1) * ny;
+            inside = x >= 0 && y >= 0 && x <= max_x && y <= max_y;
+            if (inside) profile[s] = sample_bilinear(gray, x, y);
+        }
+        if (!inside) continue;
+
+        // Dérivée centrée vers l'extérieur: encre sombre dedans, fond clair dehors
+        int best = -1;
+        float best_d = SUBPIXEL_MIN_CONTRAST;
+        for (int s = 1; s <= 2 * band + 1; s++) {
+            float d = profile[s + 1] - profile[s - 1];
+            if (d > best_d) {
+                best_d = d;
+                best = s;
             }
         }
+        if (best < 0) continue;
+
+        float offset = 0.0f;
+        if (best > 1 && best < 2 * band + 1) {
+            float dm = profile[best] - profile[best - 2];
+            float dp = profile[best + 2] - profile[best];
+            float denom = dm - 2.0f * best_d + dp;
+            if (denom < 0.0f) offset = 0.5f * (dm - dp) / denom;
+        }
+        float s = best - band - 1 + offset;
+        points[count++] = (Point2D){px + s * nx, py + s * ny};
     }
-    
-    quad->corners[0] = tl;
-    quad->corners[1] = tr;
-    quad->corners[2] = br;
-    quad->corners[3] = bl;
+    return count;
 }
 
-// ============================================================================
-// QUAD DETECTION
-// ============================================================================
+bool refine_quad_subpixel(const GrayImage *gray, Quad *quad, int band) {
+    if (band < 1) band = 1;
+    EdgeLine lines[4];
+    Point2D points[SUBPIXEL_MAX_SAMPLES];
+    bool keep[SUBPIXEL_MAX_SAMPLES];
+
+    for (int i = 0; i < 4; i++) {
+        int count = sample_edge_points(gray, quad->corners[i], quad->corners[(i + 1) % 4], band,
+                                       points);
+        for (int k = 0; k < count; k++) keep[k] = true;
+        if (!fit_line(points, keep, count, &lines[i])) return false;
+
+        // Second ajustement sans les points à plus de 2.5 écarts-types (1 px au moins)
+        double sum_sq = 0;
+        for (int k = 0; k < count; k++) {
+            float r = lines[i].nx * points[k].x + lines[i].ny * points[k].y - lines[i].c;
+            sum_sq += r * r;
+        }
+        float limit = 2.5f * (float)sqrt(sum_sq / count);
+        if (limit < 1.0f) limit = 1.0f;
+        for (int k = 0; k < count; k++) {
+            float r = lines[i].nx * points[k].x + lines[i].ny * points[k].y - lines[i].c;
+            keep[k] = fabsf(r) <= limit;
+        }
+        if (!fit_line(points, keep, count, &lines[i])) return false;
+    }
+
+    // Coin i: intersection du côté précédent (i - 1) et du côté i
+    Point2D corners[4];
+    for (int i = 0; i < 4; i++) {
+        const EdgeLine *l1 = &lines[(i + 3) % 4];
+        const EdgeLine *l2 = &lines[i];
+        float det = l1->nx * l2->ny - l1->ny * l2->nx;
+        if (fabsf(det) < 1e-3f) return false;
+        corners[i].x = (l1->c * l2->ny - l2->c * l1->ny) / det;
+        corners[i].y = (l1->nx * l2->c - l2->nx * l1->c) / det;
+        float moved = hypotf(corners[i].x - quad->corners[i].x, corners[i].y - quad->corners[i].y);
+        if (moved > 2.0f * band) return false;
+    }
+    memcpy(quad->corners, corners, sizeof(corners));
+    return true;
+}
 
 bool find_largest_quad(const GrayImage *edges, Quad *quad) {
     // Strategy 1: Largest Connected Component (Blob)
     // This is robust for Sudoku grids which are usually the largest connected object
     // especially after dilation.
     
-    int bx, by, bw, bh;
-    GrayImage *blob = find_largest_blob(edges, &bx, &by, &bw, &bh);
-    
+    // Single-pass union-find labeling: area and bounding box of every
+    // component without a label map
+    ComponentLabels labels;
+    if (!label_components(edges, 128, 0, &labels)) return false;
+    int blob = largest_component(&labels);
+
     // Check if blob is large enough (at least 1/16 of image area)
-    int img_area = edges->width * edges->height;
-    int blob_bbox_area = bw * bh;
-    
-    if (blob_bbox_area > img_area / 16) {
-        find_blob_corners(blob, quad);
-        order_quad_corners(quad);
-        gray_image_free(blob);
-        return true;
+    if (blob >= 0) {
+        const ComponentStats *stats = &labels.components[blob];
+        int img_area = edges->width * edges->height;
+        int blob_bbox_area = (stats->max_x - stats->min_x + 1) * (stats->max_y - stats->min_y + 1);
+
+        if (blob_bbox_area > img_area / 16) {
+            find_blob_corners(&labels, blob, quad);
+            order_quad_corners(quad);
+            component_labels_free(&labels);
+            return true;
+        }
     }
-    
-    gray_image_free(blob);
-    
+
+    component_labels_free(&labels);
+
     // Fallback to Hough Transform if blob is too small
     // ...existing code...
     int num_lines = 0;
     // Lower threshold to detect faint lines, we will filter later
-    HoughLine *lines = hough_lines(edges, 50, &num_lines);
+    HoughLine *lines = hough_lines_fast(edges, 50, 0, &num_lines);
     if (!lines || num_lines < 4) {
         free(lines);
         return false;
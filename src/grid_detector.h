@@ -40,9 +40,29 @@ int find_contours(const GrayImage *binary, Point2D **contours, int **contour_siz
 // ============================================================================
 
 // Trouve le plus grand quadrilatère dans l'image (grille de Sudoku)
-// Utilise les contours et approximation polygonale
+// Coins de la plus grande composante connexe (pixels > 128), repli sur la
+// transformée de Hough rapide (hough_lines_fast) si sa boîte englobante
+// couvre moins de 1/16 de l'image
 bool find_largest_quad(const GrayImage *edges, Quad *quad);
 
+// Recale chaque coin (ordonnés tl, tr, br, bl) sur l'image en niveaux de gris
+// pleine résolution: dans la fenêtre de rayon radius autour du coin, pixel
+// d'encre (plus sombre que le milieu entre min et max de la fenêtre) extrême
+// dans la direction du coin, comme pour la composante (x + y, y - x). Les
+// fenêtres sans contraste laissent le coin inchangé.
+void refine_quad_corners(const GrayImage *gray, Quad *quad, int radius);
+
+// Coins sous-pixel: chaque bord du quadrilatère (ordonné tl, tr, br, bl) est
+// échantillonné entre 10 % et 90 % de sa longueur; le long de la normale
+// (+/- band pixels, interpolation bilinéaire), le point de bord est la plus
+// forte transition encre -> fond vers l'extérieur, affinée par une parabole.
+// Une droite est ajustée par moindres carrés orthogonaux sur ces points (un
+// second ajustement écarte les points trop éloignés), puis les coins sont les
+// intersections des droites voisines.
+// Returns: false (quad inchangé) si un bord a trop peu de points ou si un coin
+//          bougerait de plus de 2 * band pixels
+bool refine_quad_subpixel(const GrayImage *gray, Quad *quad, int band);
+
 // Méthode alternative: détection par projection horizontale/verticale
 bool find_grid_by_projection(const GrayImage *edges, Quad *quad);
 
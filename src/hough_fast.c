@@ -0,0 +1,338 @@
+#include "hough_fast.h"
+#include "simd_kernels.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define DEG2RAD(x) ((x) * M_PI / 180.0f)
+#define RAD2DEG(x) ((x) * 180.0f / M_PI)
+
+#define THETA_LEN   180             // 1 degree resolution
+#define ANY_BUCKET  THETA_LEN       // Pixels sans orientation: tous les theta
+#define NUM_BUCKETS (THETA_LEN + 1)
+#define BOX_RADIUS  2               // Fenêtre 5x5 du tenseur de structure
+
+// Points de contour rangés par orientation (tri par comptage)
+typedef struct {
+    int16_t *xs;
+    int16_t *ys;
+    int start[NUM_BUCKETS + 1];     // Orientation b: points [start[b], start[b + 1])
+} OrientedPoints;
+
+static int compare_lines(const void *a, const void *b) {
+    const HoughLine *la = (const HoughLine *)a;
+    const HoughLine *lb = (const HoughLine *)b;
+    return lb->votes - la->votes; // Descending order
+}
+
+// ============================================================================
+// ORIENTATION
+// ============================================================================
+
+// Carte réduite: 1 si le bloc factor x factor contient un pixel > 128
+static uint8_t* decimate_edges(const GrayImage *edges, int factor, int coarse_width,
+                               int coarse_height) {
+    uint8_t *coarse = (uint8_t *)calloc((size_t)coarse_width * coarse_height, 1);
+    if (!coarse) return NULL;
+
+    for (size_t y = 0; y < edges->height; y++) {
+        const uint8_t *row = edges->data + y * edges->width;
+        uint8_t *coarse_row = coarse + (y / factor) * coarse_width;
+        for (size_t x = 0; x < edges->width; x++) {
+            if (row[x] > 128) coarse_row[x / factor] = 1;
+        }
+    }
+    return coarse;
+}
+
+// Somme sur la fenêtre [-BOX_RADIUS, BOX_RADIUS] (bornée à l'image) de n
+// valeurs espacées de stride
+static void box_sum(const int *src, int *dst, int n, int stride) {
+    for (int i = 0; i < n; i++) {
+        int sum = 0;
+        int begin = (i > BOX_RADIUS) ? i - BOX_RADIUS : 0;
+        int end = (i + BOX_RADIUS < n - 1) ? i + BOX_RADIUS : n - 1;
+        for (int j = begin; j <= end; j++) sum += src[j * stride];
+        dst[i * stride] = sum;
+    }
+}
+
+// Orientation de la normale (0..179 degrés) de chaque pixel actif de la carte:
+// direction dominante du tenseur de structure, ANY_BUCKET si sa cohérence est
+// sous HOUGH_FAST_MIN_COHERENCE
+static uint8_t* orientation_buckets(const uint8_t *map, int width, int height) {
+    size_t n = (size_t)width * height;
+    uint8_t *buckets = (uint8_t *)malloc(n);
+    int *tensor = (int *)malloc(6 * n * sizeof(int));  // Jxx, Jyy, Jxy puis sommes par ligne
+    if (!buckets || !tensor) {
+        free(buckets);
+        free(tensor);
+        return NULL;
+    }
+    int *jxx = tensor, *jyy = tensor + n, *jxy = tensor + 2 * n;
+
+    // Gradients de Sobel (bords répliqués)
+    for (int y = 0; y < height; y++) {
+        const uint8_t *up = map + (size_t)(y > 0 ? y - 1 : y) * width;
+        const uint8_t *mid = map + (size_t)y * width;
+        const uint8_t *down = map + (size_t)(y < height - 1 ? y + 1 : y) * width;
+        for (int x = 0; x < width; x++) {
+            int l = (x > 0) ? x - 1 : x;
+            int r = (x < width - 1) ? x + 1 : x;
+            int gx = (up[r] + 2 * mid[r] + down[r]) - (up[l] + 2 * mid[l] + down[l]);
+            int gy = (down[l] + 2 * down[x] + down[r]) - (up[l] + 2 * up[x] + up[r]);
+            size_t i = (size_t)y * width + x;
+            jxx[i] = gx * gx;
+            jyy[i] = gy * gy;
+            jxy[i] = gx * gy;
+        }
+    }
+
+    // Sommes 5x5 séparables: lignes vers la seconde moitié, colonnes en retour
+    for (int c = 0; c < 3; c++) {
+        int *src = tensor + c * n;
+        int *rows = tensor + (3 + c) * n;
+        for (int y = 0; y < height; y++) box_sum(src + (size_t)y * width, rows + (size_t)y * width, width, 1);
+        for (int x = 0; x < width; x++) box_sum(rows + x, src + x, height, width);
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        buckets[i] = ANY_BUCKET;
+        if (!map[i]) continue;
+        float a = (float)(jxx[i] - jyy[i]);
+        float b = 2.0f * jxy[i];
+        float energy = (float)(jxx[i] + jyy[i]);
+        if (energy <= 0.0f || sqrtf(a * a + b * b) < HOUGH_FAST_MIN_COHERENCE * energy) continue;
+
+        int degrees = (int)lroundf(RAD2DEG(0.5f * atan2f(b, a)));  // -90..90
+        if (degrees < 0) degrees += THETA_LEN;
+        if (degrees >= THETA_LEN) degrees -= THETA_LEN;
+        buckets[i] = (uint8_t)degrees;
+    }
+
+    free(tensor);
+    return buckets;
+}
+
+// Range les pixels >= min_value de la carte par orientation; celle du pixel
+// (x, y) est buckets[(y / scale) * bucket_width + x / scale]
+static bool collect_points(const uint8_t *map, int width, int height, uint8_t min_value,
+                           const uint8_t *buckets, int bucket_width, int scale,
+                           OrientedPoints *points) {
+    int count[NUM_BUCKETS] = {0};
+    for (int y = 0; y < height; y++) {
+        const uint8_t *row = map + (size_t)y * width;
+        const uint8_t *bucket_row = buckets + (size_t)(y / scale) * bucket_width;
+        for (int x = 0; x < width; x++) {
+            if (row[x] >= min_value) count[bucket_row[x / scale]]++;
+        }
+    }
+
+    int next[NUM_BUCKETS];
+    points->start[0] = 0;
+    for (int b = 0; b < NUM_BUCKETS; b++) {
+        next[b] = points->start[b];
+        points->start[b + 1] = points->start[b] + count[b];
+    }
+    int total = points->start[NUM_BUCKETS];
+    points->xs = (int16_t *)malloc((total ? total : 1) * sizeof(int16_t));
+    points->ys = (int16_t *)malloc((total ? total : 1) * sizeof(int16_t));
+    if (!points->xs || !points->ys) return false;
+
+    for (int y = 0; y < height; y++) {
+        const uint8_t *row = map + (size_t)y * width;
+        const uint8_t *bucket_row = buckets + (size_t)(y / scale) * bucket_width;
+        for (int x = 0; x < width; x++) {
+            if (row[x] < min_value) continue;
+            int i = next[bucket_row[x / scale]]++;
+            points->xs[i] = (int16_t)x;
+            points->ys[i] = (int16_t)y;
+        }
+    }
+    return true;
+}
+
+static void oriented_points_free(OrientedPoints *points) {
+    free(points->xs);
+    free(points->ys);
+    points->xs = NULL;
+    points->ys = NULL;
+}
+
+// ============================================================================
+// VOTE
+// ============================================================================
+
+static void vote_buckets(const OrientedPoints *points, int first, int last, float c, float s,
+                         int offset, uint16_t *row, const SimdKernels *k) {
+    int begin = points->start[first];
+    int n = points->start[last + 1] - begin;
+    if (n > 0) k->hough_vote_u16(points->xs + begin, points->ys + begin, n, c, s, offset, row);
+}
+
+// Votes du theta t: orientations à HOUGH_FAST_THETA_BAND degrés au plus
+// (circulairement, 179 voisin de 0), puis pixels sans orientation si with_any
+static void vote_theta(const OrientedPoints *points, int t, float c, float s, int offset,
+                       bool with_any, uint16_t *row, const SimdKernels *k) {
+    int lo = t - HOUGH_FAST_THETA_BAND;
+    int hi = t + HOUGH_FAST_THETA_BAND;
+    if (lo < 0) {
+        vote_buckets(points, 0, hi, c, s, offset, row, k);
+        vote_buckets(points, lo + THETA_LEN, THETA_LEN - 1, c, s, offset, row, k);
+    } else if (hi >= THETA_LEN) {
+        vote_buckets(points, lo, THETA_LEN - 1, c, s, offset, row, k);
+        vote_buckets(points, 0, hi - THETA_LEN, c, s, offset, row, k);
+    } else {
+        vote_buckets(points, lo, hi, c, s, offset, row, k);
+    }
+    if (with_any) vote_buckets(points, ANY_BUCKET, ANY_BUCKET, c, s, offset, row, k);
+}
+
+// Maximum local sur la fenêtre 3x3 (theta non circulaire, comme hough_lines)
+static bool is_local_max(const uint16_t *acc, int rho_len, int t, int r) {
+    int votes = acc[t * rho_len + r];
+    for (int nt = t - 1; nt <= t + 1; nt++) {
+        if (nt < 0 || nt >= THETA_LEN) continue;
+        for (int nr = r - 1; nr <= r + 1; nr++) {
+            if (nr < 0 || nr >= rho_len || (nt == t && nr == r)) continue;
+            if (acc[nt * rho_len + nr] > votes) return false;
+        }
+    }
+    return true;
+}
+
+// Marque les theta à band degrés au plus (circulairement) de t
+static void mark_band(bool *rows, int t, int band) {
+    for (int d = -band; d <= band; d++) rows[(t + d + THETA_LEN) % THETA_LEN] = true;
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+HoughLine* hough_lines_fast(const GrayImage *edges, int threshold, int decimation, int *num_lines) {
+    int width = (int)edges->width;
+    int height = (int)edges->height;
+    *num_lines = 0;
+    if (width > INT16_MAX || height > INT16_MAX) return hough_lines(edges, threshold, num_lines);
+
+    if (decimation <= 0) {
+        int side = (width > height) ? width : height;
+        decimation = (side + HOUGH_FAST_COARSE_SIDE - 1) / HOUGH_FAST_COARSE_SIDE;
+        if (decimation < 1) decimation = 1;
+    }
+    int coarse_width = (width + decimation - 1) / decimation;
+    int coarse_height = (height + decimation - 1) / decimation;
+    const SimdKernels *k = simd_kernels();
+
+    float sin_table[THETA_LEN];
+    float cos_table[THETA_LEN];
+    for (int t = 0; t < THETA_LEN; t++) {
+        float theta = DEG2RAD(t);
+        sin_table[t] = sin(theta);
+        cos_table[t] = cos(theta);
+    }
+
+    OrientedPoints points = {0};
+    uint16_t *accumulator = NULL;
+    HoughLine *lines = NULL;
+    bool vote_rows[THETA_LEN];      // Theta votés en pleine résolution
+    bool peak_rows[THETA_LEN];      // Theta où les pics sont retenus
+    for (int t = 0; t < THETA_LEN; t++) vote_rows[t] = peak_rows[t] = (decimation == 1);
+
+    uint8_t *coarse = decimate_edges(edges, decimation, coarse_width, coarse_height);
+    uint8_t *buckets = coarse ? orientation_buckets(coarse, coarse_width, coarse_height) : NULL;
+    bool ok = buckets != NULL;
+
+    if (ok && decimation > 1) {
+        // Vote grossier, seuil ramené à l'échelle puis divisé par deux (votes
+        // perdus par la réduction)
+        ok = collect_points(coarse, coarse_width, coarse_height, 1, buckets, coarse_width, 1, &points);
+        int diagonal = (int)sqrt(coarse_width * coarse_width + coarse_height * coarse_height);
+        int rho_len = 2 * diagonal + 1;
+        accumulator = (uint16_t *)calloc((size_t)THETA_LEN * rho_len, sizeof(uint16_t));
+        ok = ok && accumulator;
+
+        for (int t = 0; ok && t < THETA_LEN; t++) {
+            vote_theta(&points, t, cos_table[t], sin_table[t], diagonal, false,
+                       accumulator + (size_t)t * rho_len, k);
+        }
+        int coarse_threshold = threshold / (2 * decimation);
+        for (int t = 0; ok && t < THETA_LEN; t++) {
+            const uint16_t *row = accumulator + (size_t)t * rho_len;
+            for (int r = 0; r < rho_len; r++) {
+                if (row[r] > coarse_threshold && is_local_max(accumulator, rho_len, t, r)) {
+                    mark_band(peak_rows, t, HOUGH_FAST_REFINE_BAND);
+                    mark_band(vote_rows, t, HOUGH_FAST_REFINE_BAND + 1);
+                    break;
+                }
+            }
+        }
+        oriented_points_free(&points);
+        free(accumulator);
+        accumulator = NULL;
+    }
+
+    // Vote pleine résolution des theta retenus, orientation du bloc réduit;
+    // les theta voisins votés servent au test de maximum local
+    int diagonal = (int)sqrt(width * width + height * height);
+    int rho_len = 2 * diagonal + 1;
+    if (ok) {
+        ok = collect_points(edges->data, width, height, 129, buckets, coarse_width, decimation, &points);
+        accumulator = (uint16_t *)calloc((size_t)THETA_LEN * rho_len, sizeof(uint16_t));
+        ok = ok && accumulator;
+    }
+    for (int t = 0; ok && t < THETA_LEN; t++) {
+        if (vote_rows[t]) {
+            vote_theta(&points, t, cos_table[t], sin_table[t], diagonal, true,
+                       accumulator + (size_t)t * rho_len, k);
+        }
+    }
+
+    int count = 0;
+    int capacity = 1000;
+    if (ok) {
+        lines = (HoughLine *)malloc(capacity * sizeof(HoughLine));
+        ok = lines != NULL;
+    }
+    for (int t = 0; ok && t < THETA_LEN; t++) {
+        if (!peak_rows[t]) continue;
+        const uint16_t *row = accumulator + (size_t)t * rho_len;
+        for (int r = 0; r < rho_len; r++) {
+            int votes = row[r];
+            if (votes <= threshold || !is_local_max(accumulator, rho_len, t, r)) continue;
+            if (count >= capacity) {
+                capacity *= 2;
+                HoughLine *grown = (HoughLine *)realloc(lines, capacity * sizeof(HoughLine));
+                if (!grown) {
+                    ok = false;
+                    break;
+                }
+                lines = grown;
+            }
+            lines[count].rho = (float)(r - diagonal);
+            lines[count].theta = DEG2RAD(t);
+            lines[count].votes = votes;
+            count++;
+        }
+    }
+
+    oriented_points_free(&points);
+    free(accumulator);
+    free(buckets);
+    free(coarse);
+    if (!ok) {
+        LOG_ERROR("Allocation impossible (transformée de Hough)");
+        free(lines);
+        return NULL;
+    }
+
+    qsort(lines, count, sizeof(HoughLine), compare_lines);
+    *num_lines = count;
+    return lines;
+}
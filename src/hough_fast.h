@@ -0,0 +1,42 @@
+#ifndef HOUGH_FAST_H
+#define HOUGH_FAST_H
+
+#include "grid_detector.h"
+
+// ============================================================================
+// TRANSFORMÉE DE HOUGH RAPIDE
+// ============================================================================
+//
+// Même résultat que hough_lines (rho en pixels, theta au degré, pics locaux
+// 3x3 au-dessus du seuil, triés par votes décroissants) pour une fraction des
+// votes:
+// - orientation: chaque pixel de contour ne vote que dans une bande de
+//   +/- HOUGH_FAST_THETA_BAND degrés autour de la normale locale, estimée par le
+//   tenseur de structure (gradients de Sobel sommés sur 5x5) de la carte
+//   réduite; les pixels sans orientation nette (coins, croisements, zones
+//   pleines) votent pour tous les theta
+// - grossier vers fin: un premier vote des pixels orientés de la carte réduite
+//   d'un facteur D (OU logique par bloc D x D) désigne les theta des pics; le
+//   vote pleine résolution ne remplit que ces theta +/- HOUGH_FAST_REFINE_BAND
+//   degrés
+// - accumulateur 16 bits (votes saturés à 65535), rangé par theta, rempli par
+//   le noyau SIMD hough_vote_u16
+// Les lignes dont l'orientation est mal estimée sur une partie de leurs pixels
+// perdent ces votes: le résultat peut différer de hough_lines près du seuil.
+// Au-delà de 32767 pixels de côté (coordonnées 16 bits), hough_lines est
+// utilisée telle quelle.
+
+#define HOUGH_FAST_COARSE_SIDE   256    // Plus grand côté de la carte réduite (D automatique)
+#define HOUGH_FAST_THETA_BAND    8      // Demi-largeur de la bande de vote (degrés)
+#define HOUGH_FAST_REFINE_BAND   2      // Demi-largeur du raffinement autour d'un pic (degrés)
+#define HOUGH_FAST_MIN_COHERENCE 0.5f   // Cohérence minimale d'une orientation (0..1)
+
+// Lignes des pixels > 128 ayant plus de threshold votes
+// decimation: facteur D de la carte réduite, <= 0 pour le choisir d'après
+//             HOUGH_FAST_COARSE_SIDE, 1 pour un seul vote pleine résolution
+//             (restreint par l'orientation seulement)
+// Returns: tableau alloué (à libérer) et son nombre dans *num_lines, NULL si
+//          une allocation échoue
+HoughLine* hough_lines_fast(const GrayImage *edges, int threshold, int decimation, int *num_lines);
+
+#endif // HOUGH_FAST_H
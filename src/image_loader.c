@@ -1,6 +1,7 @@
 #include "image_loader.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // Implémentation STB (header-only libraries)
 #define STB_IMAGE_IMPLEMENTATION
@@ -41,6 +42,25 @@ RGBImage* load_rgb_image(const char *filename) {
     return img;
 }
 
+RGBImage* load_rgb_image_from_memory(const uint8_t *data, size_t size) {
+    int width, height, channels;
+
+    if (!data || size == 0 || size > 0x7FFFFFFF) return NULL;
+
+    unsigned char *pixels = stbi_load_from_memory(data, (int)size, &width, &height, &channels, 3);
+    if (!pixels) {
+        LOG_ERROR("Image invalide en mémoire (%zu octets): %s", size, stbi_failure_reason());
+        return NULL;
+    }
+
+    RGBImage *img = rgb_image_create(width, height, 3);
+    if (img) {
+        memcpy(img->data, pixels, (size_t)width * height * 3);
+    }
+    stbi_image_free(pixels);
+    return img;
+}
+
 GrayImage* load_gray_image(const char *filename) {
     int width, height, channels;
     
@@ -101,25 +121,41 @@ bool save_gray_image(const char *filename, const GrayImage *img) {
     }
 }
 
+uint8_t* encode_rgb_png(const RGBImage *img, size_t *size_out) {
+    int length = 0;
+    unsigned char *png = stbi_write_png_to_mem(img->data, img->width * img->channels,
+                                               img->width, img->height, img->channels, &length);
+    if (!png) {
+        LOG_ERROR("Échec encodage PNG");
+        return NULL;
+    }
+
+    *size_out = (size_t)length;
+    return png;
+}
+
 // ============================================================================
 // CONVERSIONS
 // ============================================================================
 
-GrayImage* rgb_to_gray(const RGBImage *rgb) {
-    GrayImage *gray = gray_image_create(rgb->width, rgb->height);
-    if (!gray) return NULL;
-    
+void rgb_row_to_gray(const uint8_t *rgb, size_t channels, uint8_t *gray, size_t count) {
     // Formule standard de conversion RGB -> Grayscale
     // Gray = 0.299*R + 0.587*G + 0.114*B
-    for (size_t i = 0; i < rgb->width * rgb->height; i++) {
-        size_t rgb_idx = i * rgb->channels;
-        float r = rgb->data[rgb_idx];
-        float g = rgb->data[rgb_idx + 1];
-        float b = rgb->data[rgb_idx + 2];
-        
-        gray->data[i] = (uint8_t)(0.299f * r + 0.587f * g + 0.114f * b);
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t *px = rgb + i * channels;
+        float r = px[0];
+        float g = px[1];
+        float b = px[2];
+
+        gray[i] = (uint8_t)(0.299f * r + 0.587f * g + 0.114f * b);
     }
-    
+}
+
+GrayImage* rgb_to_gray(const RGBImage *rgb) {
+    GrayImage *gray = gray_image_create(rgb->width, rgb->height);
+    if (!gray) return NULL;
+
+    rgb_row_to_gray(rgb->data, rgb->channels, gray->data, rgb->width * rgb->height);
     return gray;
 }
 
@@ -14,12 +14,20 @@ RGBImage* load_rgb_image(const char *filename);
 // Charge une image directement en niveaux de gris
 GrayImage* load_gray_image(const char *filename);
 
+// Décode une image RGB depuis un tampon mémoire (fichier JPG/PNG/BMP complet)
+// Retourne NULL si les données ne sont pas une image reconnue
+RGBImage* load_rgb_image_from_memory(const uint8_t *data, size_t size);
+
 // Sauvegarde une image RGB en PNG
 bool save_rgb_image(const char *filename, const RGBImage *img);
 
 // Sauvegarde une image en niveaux de gris en PNG
 bool save_gray_image(const char *filename, const GrayImage *img);
 
+// Encode une image RGB en PNG dans un tampon alloué (à libérer avec free())
+// size_out: taille du PNG en octets. Retourne NULL en cas d'échec
+uint8_t* encode_rgb_png(const RGBImage *img, size_t *size_out);
+
 // ============================================================================
 // CONVERSIONS
 // ============================================================================
@@ -27,6 +35,10 @@ bool save_gray_image(const char *filename, const GrayImage *img);
 // Convertit RGB vers niveaux de gris (formule standard: 0.299*R + 0.587*G + 0.114*B)
 GrayImage* rgb_to_gray(const RGBImage *rgb);
 
+// Même conversion sur count pixels consécutifs (channels octets par pixel),
+// pour les traitements par bandes
+void rgb_row_to_gray(const uint8_t *rgb, size_t channels, uint8_t *gray, size_t count);
+
 // Convertit niveaux de gris vers RGB (copie sur les 3 canaux)
 RGBImage* gray_to_rgb(const GrayImage *gray);
 
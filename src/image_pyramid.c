@@ -0,0 +1,59 @@
+#include "image_pyramid.h"
+#include "simd_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int pyramid_detect_factor(size_t width, size_t height) {
+    size_t side = (width > height) ? width : height;
+    int factor = (int)((side + PYRAMID_DETECT_SIDE / 2) / PYRAMID_DETECT_SIDE);
+    return (factor > 1) ? factor : 1;
+}
+
+RGBImage* rgb_downsample_area(const RGBImage *src, int factor) {
+    size_t width = src->width / factor;
+    size_t height = src->height / factor;
+    size_t channels = src->channels;
+    if (factor < 1 || width == 0 || height == 0) return NULL;
+
+    // Sommes de colonnes sur 16 bits: factor * 255 doit y tenir
+    if (factor > UINT16_MAX / 255) return NULL;
+
+    RGBImage *dst = rgb_image_create(width, height, channels);
+    size_t row_len = width * factor * channels;
+    uint16_t *sums = (uint16_t*)malloc(row_len * sizeof(uint16_t));
+    if (!dst || !sums) {
+        LOG_ERROR("Allocation impossible (réduction de l'image)");
+        rgb_image_free(dst);
+        free(sums);
+        return NULL;
+    }
+
+    const SimdKernels *k = simd_kernels();
+    uint32_t area = (uint32_t)factor * factor;
+    for (size_t y = 0; y < height; y++) {
+        // Sommes verticales des factor lignes du bloc, puis horizontales
+        memset(sums, 0, row_len * sizeof(uint16_t));
+        for (int dy = 0; dy < factor; dy++) {
+            k->accumulate_u8(src->data + (y * factor + dy) * src->width * channels, sums, (int)row_len);
+        }
+
+        uint8_t *out = dst->data + y * width * channels;
+        for (size_t x = 0; x < width; x++) {
+            const uint16_t *block = sums + x * factor * channels;
+            for (size_t c = 0; c < channels; c++) {
+                uint32_t sum = 0;
+                for (int dx = 0; dx < factor; dx++) sum += block[dx * channels + c];
+                out[x * channels + c] = (uint8_t)((sum + area / 2) / area);
+            }
+        }
+    }
+
+    free(sums);
+    return dst;
+}
+
+Point2D pyramid_map_point(Point2D point, int factor) {
+    float offset = (factor - 1) * 0.5f;
+    return (Point2D){point.x * factor + offset, point.y * factor + offset};
+}
@@ -0,0 +1,34 @@
+#ifndef IMAGE_PYRAMID_H
+#define IMAGE_PYRAMID_H
+
+#include "utils.h"
+
+// ============================================================================
+// PYRAMIDE: DÉTECTION À RÉSOLUTION BORNÉE
+// ============================================================================
+//
+// La détection de la grille (prétraitement, composantes, quadrilatère) ne
+// demande pas la pleine résolution d'une photo: elle tourne sur une copie
+// réduite d'un facteur entier, par moyenne de blocs factor x factor (filtre de
+// surface, sommes de lignes par le noyau SIMD accumulate_u8), dont le grand
+// côté est proche de PYRAMID_DETECT_SIDE. Les coins trouvés sont ensuite
+// ramenés en coordonnées pleine résolution.
+
+#define PYRAMID_DETECT_SIDE 800     // Grand côté visé pour la détection
+
+// Facteur de réduction entier qui rapproche le grand côté de
+// PYRAMID_DETECT_SIDE
+// Returns: 1 si le grand côté est inférieur à 1.5 * PYRAMID_DETECT_SIDE
+int pyramid_detect_factor(size_t width, size_t height);
+
+// Moyenne (arrondie) de chaque bloc factor x factor, composante par
+// composante; les width % factor dernières colonnes et height % factor
+// dernières lignes sont ignorées
+// Returns: NULL si une allocation échoue ou si l'image est plus petite qu'un bloc
+RGBImage* rgb_downsample_area(const RGBImage *src, int factor);
+
+// Point de l'image réduite ramené dans l'image d'origine (le centre d'un pixel
+// réduit est celui de son bloc)
+Point2D pyramid_map_point(Point2D point, int factor);
+
+#endif // IMAGE_PYRAMID_H
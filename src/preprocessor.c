@@ -1,12 +1,11 @@
 #include "preprocessor.h"
+#include "simd_kernels.h"
+#include "image_loader.h"
 #include <math.h>
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
 // ============================================================================
 // BINARISATION
 // ============================================================================
@@ -18,16 +17,8 @@ void threshold_binary(GrayImage *img, uint8_t threshold) {
     }
 }
 
-void threshold_otsu(GrayImage *img) {
-    // Calcul de l'histogramme
-    int histogram[256] = {0};
-    size_t total = img->width * img->height;
-    
-    for (size_t i = 0; i < total; i++) {
-        histogram[img->data[i]]++;
-    }
-    
-    // Algorithme d'Otsu
+// Seuil d'Otsu d'un histogramme de total pixels (variance inter-classes max)
+static int otsu_threshold(const int histogram[256], size_t total) {
     float sum = 0.0f;
     for (int i = 0; i < 256; i++) {
         sum += i * histogram[i];
@@ -60,153 +51,838 @@ void threshold_otsu(GrayImage *img) {
     }
     
     LOG_DEBUG("Seuil Otsu calculé: %d", threshold);
-    threshold_binary(img, threshold);
+    return threshold;
+}
+
+void threshold_otsu(GrayImage *img) {
+    // Calcul de l'histogramme
+    int histogram[256] = {0};
+    size_t total = img->width * img->height;
+    
+    for (size_t i = 0; i < total; i++) {
+        histogram[img->data[i]]++;
+    }
+    
+    threshold_binary(img, otsu_threshold(histogram, total));
+}
+
+// ----------------------------------------------------------------------------
+// Binarisation adaptative par images intégrales
+// ----------------------------------------------------------------------------
+//
+// I[y][x] = somme des pixels au-dessus et à gauche: la somme d'une fenêtre
+// vaut I[b][r] - I[t][r] - I[b][l] + I[t][l], quatre lectures quelle que soit
+// sa taille. Seules les window + 1 lignes intégrales utiles sont gardées
+// (tampon circulaire), ce qui borne la mémoire et permet de binariser en
+// place: la ligne y est écrite après le calcul des lignes intégrales
+// jusqu'à y + half, qui ne dépendent que des lignes source non encore écrites.
+// Les sommes sont en arithmétique modulo 2^32 (2^64 pour les carrés): seules
+// les différences, bornées par la fenêtre, comptent. Fenêtre tronquée aux
+// bords.
+
+// Fenêtres jusqu'à 2047 x 2047: (255 + 255) * area tient en int32
+#define ADAPTIVE_INT32_MAX_AREA (2047 * 2047)
+
+typedef struct {
+    int half;
+    bool sauvola;
+    int offset;         // Moyenne - C
+    float k;            // Sauvola
+    float inv_range;    // Sauvola: 1 / R
+} AdaptiveParams;
+
+// Seuil d'un pixel à partir de la somme (et somme des carrés) de sa fenêtre
+static inline uint8_t adaptive_pixel(uint8_t value, uint32_t sum, uint64_t sq, uint32_t area,
+                                     const AdaptiveParams *params) {
+    if (!params->sauvola) {
+        // value > sum / area - C, sans division
+        return ((int64_t)value * area > (int64_t)sum - (int64_t)params->offset * area) ? 255 : 0;
+    }
+    float mean = (float)sum / area;
+    float variance = (float)sq / area - mean * mean;
+    float deviation = (variance > 0.0f) ? sqrtf(variance) : 0.0f;
+    float threshold = mean * (1.0f + params->k * (deviation * params->inv_range - 1.0f));
+    return (value > threshold) ? 255 : 0;
+}
+
+static bool adaptive_threshold(GrayImage *img, int window, const AdaptiveParams *base) {
+    int width = (int)img->width;
+    int height = (int)img->height;
+    if (width == 0 || height == 0) return true;
+
+    AdaptiveParams params = *base;
+    params.half = (window > 1) ? window / 2 : 1;
+    int half = params.half;
+
+    // Lignes intégrales t = y - half et b = y + half + 1 (indices 1..height)
+    int ring = 2 * half + 2;
+    size_t stride = (size_t)width + 1;
+    uint32_t *sums = (uint32_t*)calloc((size_t)ring * stride, sizeof(uint32_t));
+    uint64_t *squares = params.sauvola ? (uint64_t*)calloc((size_t)ring * stride, sizeof(uint64_t)) : NULL;
+    if (!sums || (params.sauvola && !squares)) {
+        free(sums);
+        free(squares);
+        return false;
+    }
+
+    int next = 1;  // Prochaine ligne intégrale à calculer (la ligne 0 est nulle)
+    for (int y = 0; y < height; y++) {
+        int top = (y - half < 0) ? 0 : y - half;
+        int bottom = (y + half + 1 > height) ? height : y + half + 1;
+
+        for (; next <= bottom; next++) {
+            const uint8_t *src = img->data + (size_t)(next - 1) * width;
+            const uint32_t *prev = sums + (size_t)((next - 1) % ring) * stride;
+            uint32_t *cur = sums + (size_t)(next % ring) * stride;
+            uint32_t running = 0;
+            cur[0] = 0;
+            for (int x = 0; x < width; x++) {
+                running += src[x];
+                cur[x + 1] = prev[x + 1] + running;
+            }
+            if (squares) {
+                const uint64_t *prev_sq = squares + (size_t)((next - 1) % ring) * stride;
+                uint64_t *cur_sq = squares + (size_t)(next % ring) * stride;
+                uint64_t running_sq = 0;
+                cur_sq[0] = 0;
+                for (int x = 0; x < width; x++) {
+                    running_sq += (uint32_t)src[x] * src[x];
+                    cur_sq[x + 1] = prev_sq[x + 1] + running_sq;
+                }
+            }
+        }
+
+        const uint32_t *st = sums + (size_t)(top % ring) * stride;
+        const uint32_t *sb = sums + (size_t)(bottom % ring) * stride;
+        const uint64_t *qt = squares ? squares + (size_t)(top % ring) * stride : NULL;
+        const uint64_t *qb = squares ? squares + (size_t)(bottom % ring) * stride : NULL;
+        uint32_t rows = (uint32_t)(bottom - top);
+        uint8_t *row = img->data + (size_t)y * width;
+
+        // Moyenne - C à l'intérieur: fenêtre complète, lectures contiguës et
+        // comparaison en int32 (|value + C| * area < 2^31), boucle vectorisée
+        int interior_begin = width;
+        int interior_end = width;
+        int32_t area = (int32_t)rows * (2 * half + 1);
+        if (!params.sauvola && width > 2 * half && area <= ADAPTIVE_INT32_MAX_AREA) {
+            interior_begin = half;
+            interior_end = width - half;
+            const uint32_t *sb_r = sb + 2 * half + 1;
+            const uint32_t *st_r = st + 2 * half + 1;
+            int32_t offset_area = params.offset * area;
+            for (int x = interior_begin; x < interior_end; x++) {
+                int32_t sum = (int32_t)(sb_r[x - half] - st_r[x - half] - sb[x - half] + st[x - half]);
+                row[x] = ((int32_t)row[x] * area + offset_area > sum) ? 255 : 0;
+            }
+        }
+
+        for (int x = 0; x < width; x++) {
+            if (x == interior_begin) x = interior_end;
+            if (x >= width) break;
+            int l = (x - half < 0) ? 0 : x - half;
+            int r = (x + half + 1 > width) ? width : x + half + 1;
+            uint32_t sum = sb[r] - st[r] - sb[l] + st[l];
+            uint64_t sq = qt ? qb[r] - qt[r] - qb[l] + qt[l] : 0;
+            row[x] = adaptive_pixel(row[x], sum, sq, rows * (uint32_t)(r - l), &params);
+        }
+    }
+
+    free(sums);
+    free(squares);
+    return true;
+}
+
+bool threshold_mean_c(GrayImage *img, int window, int c) {
+    if (c > 255) c = 255;    // Au-delà, tout pixel passe (ou aucun)
+    if (c < -255) c = -255;
+    AdaptiveParams params = {0, false, c, 0.0f, 0.0f};
+    return adaptive_threshold(img, window, &params);
+}
+
+bool threshold_sauvola(GrayImage *img, int window, float k, float range) {
+    AdaptiveParams params = {0, true, 0, k, (range > 0.0f) ? 1.0f / range : 1.0f / 128.0f};
+    return adaptive_threshold(img, window, &params);
 }
 
 // ============================================================================
 // FILTRAGE ET DÉBRUITAGE
 // ============================================================================
 
-static float gaussian_kernel_value(int x, int y, float sigma) {
-    return expf(-(x*x + y*y) / (2.0f * sigma * sigma)) / (2.0f * M_PI * sigma * sigma);
-}
+// Poids du noyau gaussien en Q14 (somme 16384); le résultat de la passe
+// horizontale est gardé en Q8 (16 bits), celui de la passe verticale en Q22
+#define BLUR_WEIGHT_BITS 14
+#define BLUR_ROW_BITS    8
 
-GrayImage* gaussian_blur(const GrayImage *img, int kernel_size, float sigma) {
-    GrayImage *result = gray_image_create(img->width, img->height);
-    if (!result) return NULL;
-    
-    int half_k = kernel_size / 2;
-    
-    // Créer le noyau gaussien
-    float kernel[kernel_size][kernel_size];
+// Noyau 1D quantifié: exp(-i²/2σ²) normalisé. Le noyau 2D
+// exp(-(x²+y²)/2σ²) est le produit de deux noyaux 1D, donc deux passes 1D
+// (lignes puis colonnes, bords bornés dans chaque direction) donnent la même
+// convolution que la version 2D.
+static void gaussian_kernel_q14(int16_t *weights, int half_k, float sigma) {
     float sum = 0.0f;
-    
     for (int i = -half_k; i <= half_k; i++) {
-        for (int j = -half_k; j <= half_k; j++) {
-            kernel[i + half_k][j + half_k] = gaussian_kernel_value(i, j, sigma);
-            sum += kernel[i + half_k][j + half_k];
-        }
+        sum += expf(-(i * i) / (2.0f * sigma * sigma));
     }
-    
-    // Normaliser le noyau
-    for (int i = 0; i < kernel_size; i++) {
-        for (int j = 0; j < kernel_size; j++) {
-            kernel[i][j] /= sum;
+
+    // Arrondi puis correction du poids central: la somme vaut exactement 1.0
+    int total = 0;
+    for (int i = -half_k; i <= half_k; i++) {
+        float w = expf(-(i * i) / (2.0f * sigma * sigma)) / sum;
+        weights[i + half_k] = (int16_t)lroundf(w * (1 << BLUR_WEIGHT_BITS));
+        total += weights[i + half_k];
+    }
+    weights[half_k] += (int16_t)((1 << BLUR_WEIGHT_BITS) - total);
+}
+
+// Passe horizontale d'une ligne (Q8): noyau SIMD sur l'intérieur, indices
+// bornés sur les half_k pixels de chaque bord
+static void blur_row(const uint8_t *src, int width, const int16_t *weights, int half_k,
+                     uint16_t *out, const SimdKernels *kernels) {
+    int interior_begin = half_k;
+    int interior_end = width - half_k;
+    if (interior_end <= interior_begin) interior_begin = interior_end = width;
+
+    for (int x = 0; x < width; x++) {
+        if (x == interior_begin) {
+            kernels->conv_row_u8(src + x - half_k, weights, 2 * half_k + 1, out + x,
+                                 interior_end - interior_begin);
+            x = interior_end - 1;
+            continue;
         }
+        int32_t acc = 1 << (BLUR_WEIGHT_BITS - BLUR_ROW_BITS - 1);
+        for (int t = -half_k; t <= half_k; t++) {
+            int px = x + t;
+            px = (px < 0) ? 0 : (px >= width ? width - 1 : px);
+            acc += weights[t + half_k] * src[px];
+        }
+        out[x] = (uint16_t)(acc >> (BLUR_WEIGHT_BITS - BLUR_ROW_BITS));
     }
-    
-    // Appliquer la convolution
-    for (size_t y = 0; y < img->height; y++) {
-        for (size_t x = 0; x < img->width; x++) {
-            float value = 0.0f;
-            
-            for (int ky = -half_k; ky <= half_k; ky++) {
-                for (int kx = -half_k; kx <= half_k; kx++) {
-                    int px = (int)x + kx;
-                    int py = (int)y + ky;
-                    
-                    // Gestion des bordures (clamping)
-                    px = (px < 0) ? 0 : (px >= (int)img->width ? img->width - 1 : px);
-                    py = (py < 0) ? 0 : (py >= (int)img->height ? img->height - 1 : py);
-                    
-                    value += img->data[py * img->width + px] * kernel[ky + half_k][kx + half_k];
-                }
-            }
-            
-            result->data[y * result->width + x] = (uint8_t)clamp(value, 0, 255);
+}
+
+// Passe verticale de la ligne y à partir du tampon circulaire des 2 * half_k + 1
+// lignes filtrées horizontalement (vectorisée par le compilateur, poids par
+// poids). acc: width accumulateurs
+static void blur_column(const uint16_t *rows, int width, int height, int y,
+                        const int16_t *weights, int half_k, uint32_t *acc, uint8_t *dst) {
+    int taps = 2 * half_k + 1;
+    for (int x = 0; x < width; x++) acc[x] = 0;
+    for (int t = -half_k; t <= half_k; t++) {
+        int py = y + t;
+        py = (py < 0) ? 0 : (py >= height ? height - 1 : py);
+        const uint16_t *row = rows + (size_t)(py % taps) * width;
+        uint32_t w = (uint32_t)weights[t + half_k];
+        for (int x = 0; x < width; x++) acc[x] += w * row[x];
+    }
+
+    // Troncature, comme la conversion float -> uint8 de la version 2D
+    for (int x = 0; x < width; x++) {
+        dst[x] = (uint8_t)(acc[x] >> (BLUR_WEIGHT_BITS + BLUR_ROW_BITS));
+    }
+}
+
+GrayImage* gaussian_blur(const GrayImage *img, int kernel_size, float sigma) {
+    GrayImage *result = gray_image_create(img->width, img->height);
+    if (!result) return NULL;
+
+    int width = (int)img->width;
+    int height = (int)img->height;
+    int half_k = (kernel_size > 0) ? kernel_size / 2 : 0;
+    int taps = 2 * half_k + 1;
+
+    // Poids, tampon circulaire des taps dernières lignes filtrées
+    // horizontalement et accumulateurs de la passe verticale
+    int16_t *weights = (int16_t*)malloc(taps * sizeof(int16_t));
+    uint16_t *rows = (uint16_t*)malloc((size_t)taps * width * sizeof(uint16_t));
+    uint32_t *acc = (uint32_t*)malloc((size_t)width * sizeof(uint32_t));
+    if (!weights || !rows || !acc) {
+        free(weights);
+        free(rows);
+        free(acc);
+        gray_image_free(result);
+        return NULL;
+    }
+    gaussian_kernel_q14(weights, half_k, sigma);
+
+    const SimdKernels *kernels = simd_kernels();
+    int next_row = 0;  // Prochaine ligne source à filtrer horizontalement
+
+    for (int y = 0; y < height; y++) {
+        int last = (y + half_k < height) ? y + half_k : height - 1;
+        for (; next_row <= last; next_row++) {
+            blur_row(img->data + (size_t)next_row * width, width, weights, half_k,
+                     rows + (size_t)(next_row % taps) * width, kernels);
         }
+
+        blur_column(rows, width, height, y, weights, half_k, acc,
+                    result->data + (size_t)y * width);
     }
-    
+
+    free(weights);
+    free(rows);
+    free(acc);
     return result;
 }
 
-static int compare_uint8(const void *a, const void *b) {
-    return (*(uint8_t*)a - *(uint8_t*)b);
+// Histogrammes à deux niveaux (Perreault & Hébert): 16 classes grossières
+// (bits de poids fort) de 16 classes fines chacune
+#define MEDIAN_COARSE 16
+#define MEDIAN_FINE   16
+
+// Histogrammes du noyau: grossier tenu à jour à chaque pixel, fin par
+// segment et seulement à la demande (stamp: colonne centrale à laquelle le
+// segment correspond, -1 s'il est à reconstruire)
+typedef struct {
+    uint32_t coarse[MEDIAN_COARSE];
+    uint32_t fine[MEDIAN_COARSE][MEDIAN_FINE];
+    int stamp[MEDIAN_COARSE];
+} MedianKernel;
+
+static inline void median_column_update(uint16_t *col_coarse, uint16_t *col_fine,
+                                        const uint8_t *row, int width, int delta) {
+    for (int x = 0; x < width; x++) {
+        uint8_t v = row[x];
+        col_coarse[x * MEDIAN_COARSE + (v >> 4)] += (uint16_t)delta;
+        col_fine[x * 256 + v] += (uint16_t)delta;
+    }
+}
+
+// Amène le segment fin s au centre x: mise à jour par les colonnes entrées et
+// sorties depuis stamp, ou reconstruction si c'est moins cher
+static void median_sync_segment(MedianKernel *k, const uint16_t *col_fine, int s,
+                                int x, int half_k, int width) {
+    uint32_t *fine = k->fine[s];
+
+    if (k->stamp[s] < 0 || x - k->stamp[s] > 2 * half_k) {
+        memset(fine, 0, MEDIAN_FINE * sizeof(uint32_t));
+        int x0 = (x - half_k < 0) ? 0 : x - half_k;
+        int x1 = (x + half_k >= width) ? width - 1 : x + half_k;
+        for (int c = x0; c <= x1; c++) {
+            const uint16_t *col = col_fine + c * 256 + s * MEDIAN_FINE;
+            for (int b = 0; b < MEDIAN_FINE; b++) fine[b] += col[b];
+        }
+    } else {
+        for (int j = k->stamp[s] + 1; j <= x; j++) {
+            int in = j + half_k;
+            int out = j - half_k - 1;
+            if (in < width) {
+                const uint16_t *col = col_fine + in * 256 + s * MEDIAN_FINE;
+                for (int b = 0; b < MEDIAN_FINE; b++) fine[b] += col[b];
+            }
+            if (out >= 0) {
+                const uint16_t *col = col_fine + out * 256 + s * MEDIAN_FINE;
+                for (int b = 0; b < MEDIAN_FINE; b++) fine[b] -= col[b];
+            }
+        }
+    }
+    k->stamp[s] = x;
 }
 
 GrayImage* median_filter(const GrayImage *img, int kernel_size) {
     GrayImage *result = gray_image_create(img->width, img->height);
     if (!result) return NULL;
-    
-    int half_k = kernel_size / 2;
-    uint8_t *window = (uint8_t*)malloc(kernel_size * kernel_size * sizeof(uint8_t));
-    
-    for (size_t y = 0; y < img->height; y++) {
-        for (size_t x = 0; x < img->width; x++) {
-            int count = 0;
-            
-            for (int ky = -half_k; ky <= half_k; ky++) {
-                for (int kx = -half_k; kx <= half_k; kx++) {
-                    int px = (int)x + kx;
-                    int py = (int)y + ky;
-                    
-                    if (px >= 0 && px < (int)img->width && py >= 0 && py < (int)img->height) {
-                        window[count++] = img->data[py * img->width + px];
-                    }
-                }
+
+    int width = (int)img->width;
+    int height = (int)img->height;
+    int half_k = (kernel_size > 0) ? kernel_size / 2 : 0;
+
+    // Un histogramme par colonne sur les lignes y-half_k..y+half_k (bornées à
+    // l'image): au plus 2 * half_k + 1 pixels, compteurs 16 bits
+    uint16_t *col_coarse = (uint16_t*)calloc((size_t)width * MEDIAN_COARSE, sizeof(uint16_t));
+    uint16_t *col_fine = (uint16_t*)calloc((size_t)width * 256, sizeof(uint16_t));
+    if (!col_coarse || !col_fine || 2 * half_k + 1 > UINT16_MAX) {
+        free(col_coarse);
+        free(col_fine);
+        gray_image_free(result);
+        return NULL;
+    }
+
+    for (int y = 0; y < half_k && y < height; y++) {
+        median_column_update(col_coarse, col_fine, img->data + (size_t)y * width, width, 1);
+    }
+
+    MedianKernel k;
+    for (int y = 0; y < height; y++) {
+        // Fenêtre verticale: entre la ligne y + half_k, sort y - half_k - 1
+        if (y + half_k < height) {
+            median_column_update(col_coarse, col_fine, img->data + (size_t)(y + half_k) * width, width, 1);
+        }
+        if (y - half_k - 1 >= 0) {
+            median_column_update(col_coarse, col_fine, img->data + (size_t)(y - half_k - 1) * width, width, -1);
+        }
+        int y0 = (y - half_k < 0) ? 0 : y - half_k;
+        int y1 = (y + half_k >= height) ? height - 1 : y + half_k;
+        int rows = y1 - y0 + 1;
+
+        // Noyau des colonnes 0..half_k pour x = 0
+        memset(k.coarse, 0, sizeof(k.coarse));
+        for (int s = 0; s < MEDIAN_COARSE; s++) k.stamp[s] = -1;
+        for (int c = 0; c <= half_k && c < width; c++) {
+            for (int s = 0; s < MEDIAN_COARSE; s++) k.coarse[s] += col_coarse[c * MEDIAN_COARSE + s];
+        }
+
+        uint8_t *dst = result->data + (size_t)y * width;
+        for (int x = 0; x < width; x++) {
+            int x0 = (x - half_k < 0) ? 0 : x - half_k;
+            int x1 = (x + half_k >= width) ? width - 1 : x + half_k;
+
+            // Élément de rang count / 2 des pixels de la fenêtre bornée
+            uint32_t rank = (uint32_t)(rows * (x1 - x0 + 1)) / 2;
+            uint32_t seen = 0;
+            int s = 0;
+            while (seen + k.coarse[s] <= rank) seen += k.coarse[s++];
+
+            median_sync_segment(&k, col_fine, s, x, half_k, width);
+            int b = 0;
+            while (seen + k.fine[s][b] <= rank) seen += k.fine[s][b++];
+            dst[x] = (uint8_t)(s * MEDIAN_FINE + b);
+
+            // Glissement: entre la colonne x + half_k + 1, sort x - half_k
+            if (x + half_k + 1 < width) {
+                const uint16_t *col = col_coarse + (x + half_k + 1) * MEDIAN_COARSE;
+                for (int i = 0; i < MEDIAN_COARSE; i++) k.coarse[i] += col[i];
+            }
+            if (x - half_k >= 0) {
+                const uint16_t *col = col_coarse + (x - half_k) * MEDIAN_COARSE;
+                for (int i = 0; i < MEDIAN_COARSE; i++) k.coarse[i] -= col[i];
             }
-            
-            qsort(window, count, sizeof(uint8_t), compare_uint8);
-            result->data[y * result->width + x] = window[count / 2];
         }
     }
-    
-    free(window);
+
+    free(col_coarse);
+    free(col_fine);
     return result;
 }
 
-void dilate(GrayImage *img, int kernel_size) {
-    GrayImage *temp = gray_image_clone(img);
-    int half_k = kernel_size / 2;
-    
-    for (size_t y = 0; y < img->height; y++) {
-        for (size_t x = 0; x < img->width; x++) {
-            uint8_t max_val = 0;
-            
-            for (int ky = -half_k; ky <= half_k; ky++) {
-                for (int kx = -half_k; kx <= half_k; kx++) {
-                    int px = (int)x + kx;
-                    int py = (int)y + ky;
-                    
-                    if (px >= 0 && px < (int)img->width && py >= 0 && py < (int)img->height) {
-                        uint8_t val = temp->data[py * temp->width + px];
-                        if (val > max_val) max_val = val;
-                    }
-                }
+// ----------------------------------------------------------------------------
+// Morphologie: filtres max/min de van Herk / Gil-Werman
+// ----------------------------------------------------------------------------
+//
+// Fenêtre carrée séparable: max (ou min) sur les lignes puis sur les colonnes.
+// En 1D, la ligne est découpée en blocs de w = 2 * half_k + 1 pixels; g est le
+// cumul depuis le début du bloc, h depuis la fin. Toute fenêtre de w pixels
+// chevauche au plus deux blocs: out[x] = op(h[x], g[x + w - 1]), trois
+// comparaisons par pixel quelle que soit la taille du noyau. Les bords sont
+// complétés par l'élément neutre (0 pour max, 255 pour min), ce qui revient à
+// ignorer les pixels hors image.
+
+#define MORPH_STRIP_WIDTH 256   // Colonnes traitées ensemble par la passe verticale
+
+static inline uint8_t morph_op(uint8_t a, uint8_t b, bool is_max) {
+    return is_max ? (a > b ? a : b) : (a < b ? a : b);
+}
+
+// Passe 1D sur une ligne (en place)
+// pad, g, h: tampons de padded_len octets (multiple de w, >= n + 2 * half_k)
+static void vhgw_row(uint8_t *line, int n, int half_k, int padded_len, bool is_max,
+                     uint8_t *pad, uint8_t *g, uint8_t *h) {
+    int w = 2 * half_k + 1;
+    uint8_t identity = is_max ? 0 : 255;
+
+    memset(pad, identity, padded_len);
+    memcpy(pad + half_k, line, n);
+
+    for (int i = 0; i < padded_len; i++) {
+        g[i] = (i % w == 0) ? pad[i] : morph_op(g[i - 1], pad[i], is_max);
+    }
+    for (int i = padded_len - 1; i >= 0; i--) {
+        h[i] = (i % w == w - 1) ? pad[i] : morph_op(h[i + 1], pad[i], is_max);
+    }
+    for (int x = 0; x < n; x++) {
+        line[x] = morph_op(h[x], g[x + w - 1], is_max);
+    }
+}
+
+// Même passe sur les colonnes, par bandes de MORPH_STRIP_WIDTH colonnes: les
+// cumuls sont faits ligne par ligne sur toute la bande (boucles vectorisables)
+// g, h: tampons de padded_len * MORPH_STRIP_WIDTH octets
+static void vhgw_columns(GrayImage *img, int half_k, int padded_len, bool is_max,
+                         uint8_t *g, uint8_t *h) {
+    int width = (int)img->width;
+    int height = (int)img->height;
+    int w = 2 * half_k + 1;
+    uint8_t identity = is_max ? 0 : 255;
+
+    for (int c0 = 0; c0 < width; c0 += MORPH_STRIP_WIDTH) {
+        int sw = (width - c0 < MORPH_STRIP_WIDTH) ? width - c0 : MORPH_STRIP_WIDTH;
+
+        for (int i = 0; i < padded_len; i++) {
+            int y = i - half_k;
+            uint8_t *gi = g + (size_t)i * MORPH_STRIP_WIDTH;
+            if (y < 0 || y >= height) {
+                if (i % w == 0) memset(gi, identity, sw);
+                else memcpy(gi, gi - MORPH_STRIP_WIDTH, sw);
+                continue;
+            }
+            const uint8_t *src = img->data + (size_t)y * width + c0;
+            if (i % w == 0) {
+                memcpy(gi, src, sw);
+            } else {
+                const uint8_t *prev = gi - MORPH_STRIP_WIDTH;
+                for (int c = 0; c < sw; c++) gi[c] = morph_op(prev[c], src[c], is_max);
+            }
+        }
+
+        for (int i = padded_len - 1; i >= 0; i--) {
+            int y = i - half_k;
+            uint8_t *hi = h + (size_t)i * MORPH_STRIP_WIDTH;
+            if (y < 0 || y >= height) {
+                if (i % w == w - 1) memset(hi, identity, sw);
+                else memcpy(hi, hi + MORPH_STRIP_WIDTH, sw);
+                continue;
+            }
+            const uint8_t *src = img->data + (size_t)y * width + c0;
+            if (i % w == w - 1) {
+                memcpy(hi, src, sw);
+            } else {
+                const uint8_t *next = hi + MORPH_STRIP_WIDTH;
+                for (int c = 0; c < sw; c++) hi[c] = morph_op(next[c], src[c], is_max);
             }
-            
-            img->data[y * img->width + x] = max_val;
+        }
+
+        for (int y = 0; y < height; y++) {
+            const uint8_t *hy = h + (size_t)y * MORPH_STRIP_WIDTH;
+            const uint8_t *gy = g + (size_t)(y + w - 1) * MORPH_STRIP_WIDTH;
+            uint8_t *dst = img->data + (size_t)y * width + c0;
+            for (int c = 0; c < sw; c++) dst[c] = morph_op(hy[c], gy[c], is_max);
         }
     }
-    
-    gray_image_free(temp);
 }
 
-void erode(GrayImage *img, int kernel_size) {
-    GrayImage *temp = gray_image_clone(img);
-    int half_k = kernel_size / 2;
-    
+static void morphology(GrayImage *img, int kernel_size, bool is_max) {
+    int half_k = (kernel_size > 0) ? kernel_size / 2 : 0;
+    if (half_k == 0 || img->width == 0 || img->height == 0) return;
+
+    int w = 2 * half_k + 1;
+    int longest = (img->width > img->height) ? (int)img->width : (int)img->height;
+    int padded_len = ((longest + 2 * half_k + w - 1) / w) * w;
+
+    // pad, g et h d'une ligne, puis g et h d'une bande de colonnes
+    size_t row_bytes = (size_t)padded_len * 3;
+    size_t strip_bytes = (size_t)padded_len * MORPH_STRIP_WIDTH;
+    uint8_t *buffer = (uint8_t*)malloc(row_bytes + 2 * strip_bytes);
+    if (!buffer) {
+        LOG_ERROR("Allocation impossible (morphologie)");
+        return;
+    }
+    uint8_t *pad = buffer;
+    uint8_t *g = buffer + padded_len;
+    uint8_t *h = buffer + 2 * (size_t)padded_len;
+
+    int row_len = (((int)img->width + 2 * half_k + w - 1) / w) * w;
     for (size_t y = 0; y < img->height; y++) {
-        for (size_t x = 0; x < img->width; x++) {
-            uint8_t min_val = 255;
-            
-            for (int ky = -half_k; ky <= half_k; ky++) {
-                for (int kx = -half_k; kx <= half_k; kx++) {
-                    int px = (int)x + kx;
-                    int py = (int)y + ky;
-                    
-                    if (px >= 0 && px < (int)img->width && py >= 0 && py < (int)img->height) {
-                        uint8_t val = temp->data[py * temp->width + px];
-                        if (val < min_val) min_val = val;
-                    }
-                }
+        vhgw_row(img->data + y * img->width, (int)img->width, half_k, row_len, is_max, pad, g, h);
+    }
+
+    int col_len = (((int)img->height + 2 * half_k + w - 1) / w) * w;
+    vhgw_columns(img, half_k, col_len, is_max, buffer + row_bytes, buffer + row_bytes + strip_bytes);
+
+    free(buffer);
+}
+
+void dilate(GrayImage *img, int kernel_size) {
+    morphology(img, kernel_size, true);
+}
+
+void erode(GrayImage *img, int kernel_size) {
+    morphology(img, kernel_size, false);
+}
+
+// ----------------------------------------------------------------------------
+// Morphologie binaire: 64 pixels par mot
+// ----------------------------------------------------------------------------
+//
+// Ligne horizontale: union de décalages de la ligne de bits, par doublement du
+// rayon (log2(half_k) étapes). Verticale: van Herk / Gil-Werman sur des mots
+// (OR à la place du max). L'érosion est le complément de la dilatation du
+// complément, les pixels hors image restant neutres (0 dans le complément).
+
+// dst = src décalé de shift bits vers les x croissants (shift > 0) ou
+// décroissants (shift < 0), bits entrants à 0
+static void bits_shift(const uint64_t *src, uint64_t *dst, int words, int shift) {
+    int word_shift = (shift >= 0 ? shift : -shift) / 64;
+    int bit_shift = (shift >= 0 ? shift : -shift) % 64;
+
+    for (int j = 0; j < words; j++) {
+        int from = (shift >= 0) ? j - word_shift : j + word_shift;
+        uint64_t lo = (from >= 0 && from < words) ? src[from] : 0;
+        if (bit_shift == 0) {
+            dst[j] = lo;
+            continue;
+        }
+        if (shift >= 0) {
+            uint64_t carry = (from - 1 >= 0 && from - 1 < words) ? src[from - 1] : 0;
+            dst[j] = (lo << bit_shift) | (carry >> (64 - bit_shift));
+        } else {
+            uint64_t carry = (from + 1 >= 0 && from + 1 < words) ? src[from + 1] : 0;
+            dst[j] = (lo >> bit_shift) | (carry << (64 - bit_shift));
+        }
+    }
+}
+
+#define BYTES_HIGH 0x8080808080808080ull
+#define BYTES_LOW7 0x7F7F7F7F7F7F7F7Full
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+// Bit de poids fort de chaque octet non nul
+static inline uint64_t bytes_nonzero(uint64_t v) {
+    return (((v & BYTES_LOW7) + BYTES_LOW7) | v) & BYTES_HIGH;
+}
+#endif
+
+// 8 pixels -> 8 bits (bit i: pixel i non nul)
+static inline uint64_t pack8(const uint8_t *p) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return ((bytes_nonzero(v) >> 7) * 0x0102040810204080ull) >> 56;  // Regroupe les 8 bits
+#else
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; i++) bits |= (uint64_t)(p[i] != 0) << i;
+    return bits;
+#endif
+}
+
+// 8 bits -> 8 pixels (on si le bit est à 1, off sinon)
+static inline void unpack8(uint64_t bits, uint8_t *p, uint8_t on, uint8_t off) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t spread = (bits * 0x0101010101010101ull) & 0x8040201008040201ull;  // Bit i dans l'octet i
+    uint64_t mask = (bytes_nonzero(spread) >> 7) * 0xFF;
+    uint64_t v = (mask & (on * 0x0101010101010101ull)) | (~mask & (off * 0x0101010101010101ull));
+    memcpy(p, &v, 8);
+#else
+    for (int i = 0; i < 8; i++) p[i] = ((bits >> i) & 1) ? on : off;
+#endif
+}
+
+// Dilatation horizontale d'une ligne de bits par un rayon half_k (en place):
+// au rayon r, l'union avec les décalages de +-s (s <= r + 1) donne le rayon r + s
+// tmp: 2 * words mots
+static void bits_dilate_row(uint64_t *row, uint64_t *tmp, int words, int half_k) {
+    uint64_t *right = tmp;
+    uint64_t *left = tmp + words;
+    int radius = 0;
+
+    while (radius < half_k) {
+        int step = (radius + 1 < half_k - radius) ? radius + 1 : half_k - radius;
+        bits_shift(row, right, words, step);
+        bits_shift(row, left, words, -step);
+        for (int j = 0; j < words; j++) row[j] |= right[j] | left[j];
+        radius += step;
+    }
+}
+
+// Ligne de width pixels -> (width + 63) / 64 mots, bits au-delà de width à 0
+static void pack_row(const uint8_t *src, int width, uint64_t *row) {
+    int words = (width + 63) / 64;
+    for (int j = 0; j < words; j++) {
+        int x0 = j * 64;
+        int n = (width - x0 < 64) ? width - x0 : 64;
+        uint64_t word = 0;
+        int i = 0;
+        for (; i + 8 <= n; i += 8) word |= pack8(src + x0 + i) << i;
+        for (; i < n; i++) word |= (uint64_t)(src[x0 + i] != 0) << i;
+        row[j] = word;
+    }
+}
+
+// Mots -> width pixels (on/off), bits au-delà de width ignorés
+static void unpack_row(const uint64_t *row, int width, uint8_t *dst, uint8_t on, uint8_t off) {
+    int words = (width + 63) / 64;
+    for (int j = 0; j < words; j++) {
+        uint64_t word = row[j];
+        int x0 = j * 64;
+        int n = (width - x0 < 64) ? width - x0 : 64;
+        int i = 0;
+        for (; i + 8 <= n; i += 8) unpack8((word >> i) & 0xFF, dst + x0 + i, on, off);
+        for (; i < n; i++) dst[x0 + i] = ((word >> i) & 1) ? on : off;
+    }
+}
+
+static void binary_morphology(GrayImage *img, int kernel_size, bool dilation) {
+    int half_k = (kernel_size > 0) ? kernel_size / 2 : 0;
+    int width = (int)img->width;
+    int height = (int)img->height;
+    if (half_k == 0 || width == 0 || height == 0) return;
+
+    int words = (width + 63) / 64;
+    int w = 2 * half_k + 1;
+    int col_len = ((height + 2 * half_k + w - 1) / w) * w;
+    uint64_t last_mask = (width % 64) ? ((1ull << (width % 64)) - 1) : ~0ull;
+
+    // Lignes de bits, cumuls g et h de la passe verticale, temporaires
+    size_t row_words = (size_t)height * words;
+    size_t cum_words = (size_t)col_len * words;
+    uint64_t *bits = (uint64_t*)malloc((row_words + 2 * cum_words + 2 * words) * sizeof(uint64_t));
+    if (!bits) {
+        LOG_ERROR("Allocation impossible (morphologie binaire)");
+        return;
+    }
+    uint64_t *g = bits + row_words;
+    uint64_t *h = g + cum_words;
+    uint64_t *tmp = h + cum_words;
+
+    // Empaquetage (complément pour l'érosion), bits au-delà de width à 0
+    for (int y = 0; y < height; y++) {
+        uint64_t *row = bits + (size_t)y * words;
+        pack_row(img->data + (size_t)y * width, width, row);
+        if (!dilation) {
+            for (int j = 0; j < words; j++) row[j] = ~row[j];
+            row[words - 1] &= last_mask;
+        }
+        bits_dilate_row(row, tmp, words, half_k);
+    }
+
+    // Passe verticale: van Herk / Gil-Werman avec OR, lignes hors image à 0
+    for (int i = 0; i < col_len; i++) {
+        int y = i - half_k;
+        uint64_t *gi = g + (size_t)i * words;
+        const uint64_t *src = (y >= 0 && y < height) ? bits + (size_t)y * words : NULL;
+        for (int j = 0; j < words; j++) {
+            uint64_t v = src ? src[j] : 0;
+            gi[j] = (i % w == 0) ? v : (gi[j - words] | v);
+        }
+    }
+    for (int i = col_len - 1; i >= 0; i--) {
+        int y = i - half_k;
+        uint64_t *hi = h + (size_t)i * words;
+        const uint64_t *src = (y >= 0 && y < height) ? bits + (size_t)y * words : NULL;
+        for (int j = 0; j < words; j++) {
+            uint64_t v = src ? src[j] : 0;
+            hi[j] = (i % w == w - 1) ? v : (hi[j + words] | v);
+        }
+    }
+
+    // Dépaquetage: dilatation du complément couverte = pixel érodé
+    uint8_t on = dilation ? 255 : 0;
+    uint8_t off = dilation ? 0 : 255;
+    for (int y = 0; y < height; y++) {
+        const uint64_t *hy = h + (size_t)y * words;
+        const uint64_t *gy = g + (size_t)(y + w - 1) * words;
+        for (int j = 0; j < words; j++) tmp[j] = hy[j] | gy[j];
+        unpack_row(tmp, width, img->data + (size_t)y * width, on, off);
+    }
+
+    free(bits);
+}
+
+void dilate_binary(GrayImage *img, int kernel_size) {
+    binary_morphology(img, kernel_size, true);
+}
+
+void erode_binary(GrayImage *img, int kernel_size) {
+    binary_morphology(img, kernel_size, false);
+}
+
+// ============================================================================
+// PRÉTRAITEMENT FUSIONNÉ
+// ============================================================================
+//
+// Deux passes par lignes au lieu de sept images allouées et parcourues tour à
+// tour (gris, flou, copie, Otsu, inversion, copie, dilatation):
+// - passe 1: chaque ligne RGB est convertie en gris (image gardée pour la
+//   composition) puis filtrée horizontalement dans le tampon circulaire du
+//   flou; la ligne floutée est écrite dans binary et comptée dans
+//   l'histogramme d'Otsu;
+// - passe 2: le seuil connu, chaque ligne de binary est seuillée et inversée
+//   en place, puis empaquetée en bits et dilatée horizontalement dans un
+//   tampon circulaire de dilate_kernel lignes; la ligne dilatée est l'union
+//   des lignes du tampon (lignes hors image neutres).
+// Seule la relecture de l'image floutée, imposée par l'histogramme global,
+// parcourt une seconde fois une image complète. Mêmes briques que
+// gaussian_blur, threshold_otsu et dilate_binary: résultat identique octet
+// pour octet.
+
+void preprocessed_images_free(PreprocessedImages *images) {
+    gray_image_free(images->gray);
+    gray_image_free(images->blurred);
+    gray_image_free(images->binary);
+    gray_image_free(images->dilated);
+    memset(images, 0, sizeof(PreprocessedImages));
+}
+
+bool preprocess_fused(const RGBImage *rgb, int blur_kernel, float sigma, int dilate_kernel,
+                      bool keep_blurred, PreprocessedImages *out) {
+    memset(out, 0, sizeof(PreprocessedImages));
+    int width = (int)rgb->width;
+    int height = (int)rgb->height;
+    int half_k = (blur_kernel > 0) ? blur_kernel / 2 : 0;
+    int taps = 2 * half_k + 1;
+    int half_d = (dilate_kernel > 0) ? dilate_kernel / 2 : 0;
+    int ring = 2 * half_d + 1;
+    int words = (width + 63) / 64;
+
+    // Images produites, puis tampons de quelques lignes: flou (taps lignes
+    // Q8 + accumulateurs), dilatation (ring lignes de bits + temporaires)
+    out->gray = gray_image_create(rgb->width, rgb->height);
+    out->binary = gray_image_create(rgb->width, rgb->height);
+    out->dilated = gray_image_create(rgb->width, rgb->height);
+    int16_t *weights = (int16_t*)malloc(taps * sizeof(int16_t));
+    uint16_t *rows = (uint16_t*)malloc((size_t)taps * width * sizeof(uint16_t));
+    uint32_t *acc = (uint32_t*)malloc((size_t)width * sizeof(uint32_t));
+    uint64_t *bits = (uint64_t*)malloc((size_t)(ring + 2) * words * sizeof(uint64_t));
+    bool ok = out->gray && out->binary && out->dilated && weights && rows && acc && bits;
+
+    if (ok) {
+        gaussian_kernel_q14(weights, half_k, sigma);
+        const SimdKernels *kernels = simd_kernels();
+
+        // Passe 1: gris, flou et histogramme
+        int histogram[256] = {0};
+        int next_row = 0;  // Prochaine ligne à convertir et filtrer horizontalement
+        for (int y = 0; y < height; y++) {
+            int last = (y + half_k < height) ? y + half_k : height - 1;
+            for (; next_row <= last; next_row++) {
+                uint8_t *gray_row = out->gray->data + (size_t)next_row * width;
+                rgb_row_to_gray(rgb->data + (size_t)next_row * width * rgb->channels,
+                                rgb->channels, gray_row, (size_t)width);
+                blur_row(gray_row, width, weights, half_k,
+                         rows + (size_t)(next_row % taps) * width, kernels);
             }
-            
-            img->data[y * img->width + x] = min_val;
+
+            uint8_t *dst = out->binary->data + (size_t)y * width;
+            blur_column(rows, width, height, y, weights, half_k, acc, dst);
+            for (int x = 0; x < width; x++) histogram[dst[x]]++;
+        }
+
+        if (keep_blurred) {
+            out->blurred = gray_image_clone(out->binary);
+            ok = out->blurred != NULL;
+        }
+
+        // Passe 2: seuil + inversion en place, dilatation par bandes
+        int threshold = otsu_threshold(histogram, (size_t)width * height);
+        out->threshold = threshold;
+        uint64_t *tmp = bits + (size_t)ring * words;
+        int next_packed = 0;  // Prochaine ligne à seuiller et empaqueter
+        for (int y = 0; ok && y < height; y++) {
+            int last = (y + half_d < height) ? y + half_d : height - 1;
+            for (; next_packed <= last; next_packed++) {
+                uint8_t *row = out->binary->data + (size_t)next_packed * width;
+                for (int x = 0; x < width; x++) row[x] = (row[x] > threshold) ? 0 : 255;
+
+                uint64_t *packed = bits + (size_t)(next_packed % ring) * words;
+                pack_row(row, width, packed);
+                bits_dilate_row(packed, tmp, words, half_d);
+            }
+
+            int top = (y - half_d < 0) ? 0 : y - half_d;
+            for (int j = 0; j < words; j++) tmp[j] = 0;
+            for (int py = top; py <= last; py++) {
+                const uint64_t *packed = bits + (size_t)(py % ring) * words;
+                for (int j = 0; j < words; j++) tmp[j] |= packed[j];
+            }
+            unpack_row(tmp, width, out->dilated->data + (size_t)y * width, 255, 0);
         }
     }
-    
-    gray_image_free(temp);
+
+    free(weights);
+    free(rows);
+    free(acc);
+    free(bits);
+    if (!ok) {
+        LOG_ERROR("Allocation impossible (prétraitement fusionné)");
+        preprocessed_images_free(out);
+    }
+    return ok;
 }
 
 // ============================================================================
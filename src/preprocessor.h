@@ -14,22 +14,70 @@ void threshold_binary(GrayImage *img, uint8_t threshold);
 // Calcule automatiquement le seuil optimal
 void threshold_otsu(GrayImage *img);
 
+// Binarisation locale: chaque pixel est comparé à la moyenne de sa fenêtre
+// window x window (tronquée aux bords), calculée sur des images intégrales:
+// coût par pixel indépendant de window, mémoire O(window * largeur), en place.
+// Pixel > seuil local -> 255, sinon 0.
+// Returns: false si l'allocation échoue (image inchangée)
+
+// Seuil = moyenne - c
+bool threshold_mean_c(GrayImage *img, int window, int c);
+
+// Seuil de Sauvola = moyenne * (1 + k * (écart-type / range - 1)); robuste aux
+// ombres et au fond peu contrasté (k ~ 0.2-0.5, range = 128 pour 8 bits)
+bool threshold_sauvola(GrayImage *img, int window, float k, float range);
+
 // ============================================================================
 // FILTRAGE ET DÉBRUITAGE
 // ============================================================================
 
 // Filtre gaussien pour réduire le bruit
+// Deux passes 1D à poids entiers (ligne vectorisée, bords bornés); écart d'au
+// plus 1 niveau avec la convolution 2D en float
 GrayImage* gaussian_blur(const GrayImage *img, int kernel_size, float sigma);
 
 // Filtre médian (très efficace contre le bruit sel-poivre)
+// Histogrammes glissants (Perreault): coût par pixel indépendant de
+// kernel_size. Fenêtre tronquée aux bords, médiane = élément de rang n/2.
 GrayImage* median_filter(const GrayImage *img, int kernel_size);
 
 // Dilatation morphologique (épaissit les objets blancs)
+// Fenêtre carrée, séparable (van Herk / Gil-Werman): coût par pixel
+// indépendant de kernel_size; les pixels hors image sont ignorés
 void dilate(GrayImage *img, int kernel_size);
 
 // Érosion morphologique (amincit les objets blancs)
 void erode(GrayImage *img, int kernel_size);
 
+// Mêmes opérations sur une image binaire, empaquetée à 64 pixels par mot:
+// tout pixel non nul compte comme 255, le résultat vaut 0 ou 255 (identique à
+// dilate()/erode() sur une image 0/255)
+void dilate_binary(GrayImage *img, int kernel_size);
+void erode_binary(GrayImage *img, int kernel_size);
+
+// ============================================================================
+// PRÉTRAITEMENT FUSIONNÉ
+// ============================================================================
+
+typedef struct {
+    GrayImage *gray;        // Niveaux de gris
+    GrayImage *blurred;     // Image floutée (si demandée), sinon NULL
+    GrayImage *binary;      // Flou + Otsu + inversion: traits blancs sur noir
+    GrayImage *dilated;     // binary dilatée (fenêtre dilate_kernel)
+    int threshold;          // Seuil d'Otsu retenu (flou > threshold: fond)
+} PreprocessedImages;
+
+// Équivalent de rgb_to_gray, gaussian_blur, threshold_otsu, invert_image et
+// dilate_binary sur une copie, en deux passes par bandes de lignes avec des
+// tampons de quelques lignes: seule la passe de seuil relit une image entière
+// keep_blurred: garde aussi une copie de l'image floutée (debug)
+// Returns: false si une allocation échoue (out remis à zéro)
+bool preprocess_fused(const RGBImage *rgb, int blur_kernel, float sigma, int dilate_kernel,
+                      bool keep_blurred, PreprocessedImages *out);
+
+// Libère les images (champs NULL acceptés) et remet les champs à NULL
+void preprocessed_images_free(PreprocessedImages *images);
+
 // ============================================================================
 // NORMALISATION
 // ============================================================================
@@ -0,0 +1,641 @@
+#include "simd_kernels.h"
+#include "utils.h"
+#include <math.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+// ============================================================================
+// NOYAUX SCALAIRES (RÉFÉRENCE ET QUEUES DE BOUCLE)
+// ============================================================================
+
+static float dot_scalar(const float *a, const float *b, int n) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+static void axpy_scalar(float alpha, const float *x, float *y, int n) {
+    for (int i = 0; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+static void bias_relu_scalar(float *x, float bias, int n) {
+    for (int i = 0; i < n; i++) {
+        x[i] = relu(x[i] + bias);
+    }
+}
+
+static void max_pool2x2_row_scalar(const float *row0, const float *row1, float *out, int out_w) {
+    for (int i = 0; i < out_w; i++) {
+        float m = row0[2 * i];
+        if (row0[2 * i + 1] > m) m = row0[2 * i + 1];
+        if (row1[2 * i] > m) m = row1[2 * i];
+        if (row1[2 * i + 1] > m) m = row1[2 * i + 1];
+        out[i] = m;
+    }
+}
+
+static void softmax_scalar(const float *input, float *output, int n) {
+    softmax(input, output, n);
+}
+
+static int32_t dot_u8s8_scalar(const uint8_t *a, const int8_t *b, int n) {
+    int32_t sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += (int32_t)a[i] * (int32_t)b[i];
+    }
+    return sum;
+}
+
+static void madd_s16_pairs_scalar(const int16_t *x, int32_t w_pair, int32_t *acc, int n) {
+    int32_t w0 = (int16_t)(w_pair & 0xFFFF);
+    int32_t w1 = (int16_t)((uint32_t)w_pair >> 16);
+    for (int j = 0; j < n; j++) {
+        acc[j] += x[2 * j] * w0 + x[2 * j + 1] * w1;
+    }
+}
+
+static void conv_row_u8_scalar(const uint8_t *src, const int16_t *weights, int taps,
+                               uint16_t *out, int n) {
+    for (int x = 0; x < n; x++) {
+        int32_t acc = 32;
+        for (int t = 0; t < taps; t++) {
+            acc += weights[t] * src[x + t];
+        }
+        out[x] = (uint16_t)(acc >> 6);
+    }
+}
+
+static void hough_vote_u16_scalar(const int16_t *xs, const int16_t *ys, int n, float c, float s,
+                                  int offset, uint16_t *acc) {
+    for (int i = 0; i < n; i++) {
+        uint16_t *bin = acc + (int)(xs[i] * c + ys[i] * s) + offset;
+        *bin += (*bin != UINT16_MAX);
+    }
+}
+
+static void accumulate_u8_scalar(const uint8_t *src, uint16_t *acc, int n) {
+    for (int i = 0; i < n; i++) acc[i] += src[i];
+}
+
+// Le max et la somme sont vectorisés, expf reste celui de la libm pour que
+// les probabilités soient identiques quel que soit le niveau choisi
+static void softmax_with_max(const float *input, float *output, int n, float max_val) {
+    float sum = 0.0f;
+    for (int i = 0; i < n; i++) {
+        output[i] = expf(input[i] - max_val);
+        sum += output[i];
+    }
+
+    for (int i = 0; i < n; i++) {
+        output[i] /= sum;
+    }
+}
+
+#ifdef SIMD_X86
+
+// ============================================================================
+// SSE2 (4 FLOATS)
+// ============================================================================
+
+static float hsum_sse(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+}
+
+static float hmax_sse(__m128 v) {
+    __m128 shuf = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 m = _mm_max_ps(v, shuf);
+    shuf = _mm_movehl_ps(shuf, m);
+    m = _mm_max_ss(m, shuf);
+    return _mm_cvtss_f32(m);
+}
+
+static float dot_sse2(const float *a, const float *b, int n) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    for (; i + 4 <= n; i += 4) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+
+    float sum = hsum_sse(_mm_add_ps(acc0, acc1));
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+static void axpy_sse2(float alpha, const float *x, float *y, int n) {
+    __m128 va = _mm_set1_ps(alpha);
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        __m128 vy = _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(va, _mm_loadu_ps(x + i)));
+        _mm_storeu_ps(y + i, vy);
+    }
+    for (; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+static void bias_relu_sse2(float *x, float bias, int n) {
+    __m128 vb = _mm_set1_ps(bias);
+    __m128 zero = _mm_setzero_ps();
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(x + i, _mm_max_ps(_mm_add_ps(_mm_loadu_ps(x + i), vb), zero));
+    }
+    for (; i < n; i++) {
+        x[i] = relu(x[i] + bias);
+    }
+}
+
+static void max_pool2x2_row_sse2(const float *row0, const float *row1, float *out, int out_w) {
+    int i = 0;
+
+    // 8 entrées par ligne -> 4 sorties
+    for (; i + 4 <= out_w; i += 4) {
+        __m128 a = _mm_max_ps(_mm_loadu_ps(row0 + 2 * i), _mm_loadu_ps(row1 + 2 * i));
+        __m128 b = _mm_max_ps(_mm_loadu_ps(row0 + 2 * i + 4), _mm_loadu_ps(row1 + 2 * i + 4));
+        __m128 even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        _mm_storeu_ps(out + i, _mm_max_ps(even, odd));
+    }
+    if (i < out_w) {
+        max_pool2x2_row_scalar(row0 + 2 * i, row1 + 2 * i, out + i, out_w - i);
+    }
+}
+
+static void softmax_sse2(const float *input, float *output, int n) {
+    __m128 vmax = _mm_set1_ps(-INFINITY);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        vmax = _mm_max_ps(vmax, _mm_loadu_ps(input + i));
+    }
+
+    float max_val = hmax_sse(vmax);
+    for (; i < n; i++) {
+        if (input[i] > max_val) max_val = input[i];
+    }
+
+    softmax_with_max(input, output, n, max_val);
+}
+
+static int32_t hsum_epi32_sse(__m128i v) {
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+// 16 paires par itération: uint8 étendu par des zéros, int8 par son signe
+// (unpack avec lui-même puis décalage arithmétique), puis madd 16 bits -> 32 bits
+static int32_t dot_u8s8_sse2(const uint8_t *a, const int8_t *b, int n) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        __m128i a_lo = _mm_unpacklo_epi8(va, zero);
+        __m128i a_hi = _mm_unpackhi_epi8(va, zero);
+        __m128i b_lo = _mm_srai_epi16(_mm_unpacklo_epi8(vb, vb), 8);
+        __m128i b_hi = _mm_srai_epi16(_mm_unpackhi_epi8(vb, vb), 8);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a_lo, b_lo));
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(a_hi, b_hi));
+    }
+
+    int32_t sum = hsum_epi32_sse(acc);
+    for (; i < n; i++) {
+        sum += (int32_t)a[i] * (int32_t)b[i];
+    }
+    return sum;
+}
+
+static void madd_s16_pairs_sse2(const int16_t *x, int32_t w_pair, int32_t *acc, int n) {
+    __m128i vw = _mm_set1_epi32(w_pair);
+    int j = 0;
+
+    for (; j + 4 <= n; j += 4) {
+        __m128i prod = _mm_madd_epi16(_mm_loadu_si128((const __m128i*)(x + 2 * j)), vw);
+        __m128i *dst = (__m128i*)(acc + j);
+        _mm_storeu_si128(dst, _mm_add_epi32(_mm_loadu_si128(dst), prod));
+    }
+    if (j < n) {
+        madd_s16_pairs_scalar(x + 2 * j, w_pair, acc + j, n - j);
+    }
+}
+
+// Paire de poids (w0, w1) pour madd; w1 = 0 pour le dernier poids d'un noyau impair
+static inline __m128i weight_pair_sse2(const int16_t *weights, int t, int taps) {
+    int16_t w1 = (t + 1 < taps) ? weights[t + 1] : 0;
+    return _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)w1 << 16) | (uint16_t)weights[t]));
+}
+
+// 8 sorties par itération, deux poids par madd: les pixels src[x+t] et
+// src[x+t+1] sont entrelacés en paires 16 bits
+static void conv_row_u8_sse2(const uint8_t *src, const int16_t *weights, int taps,
+                             uint16_t *out, int n) {
+    __m128i zero = _mm_setzero_si128();
+    __m128i round = _mm_set1_epi32(32);
+    __m128i bias32 = _mm_set1_epi32(32768);
+    __m128i bias16 = _mm_set1_epi16((int16_t)0x8000);
+    int x = 0;
+
+    // Lecture de src[x + taps]: dernière paire d'un noyau impair (poids nul)
+    for (; x + 8 + 1 <= n; x += 8) {
+        __m128i acc_lo = round;
+        __m128i acc_hi = round;
+        for (int t = 0; t < taps; t += 2) {
+            __m128i p0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + x + t)), zero);
+            __m128i p1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(src + x + t + 1)), zero);
+            __m128i w = weight_pair_sse2(weights, t, taps);
+            acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(_mm_unpacklo_epi16(p0, p1), w));
+            acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(_mm_unpackhi_epi16(p0, p1), w));
+        }
+        // Sorties <= 65280: pack signé après décalage de 32768 (pas de packus_epi32 en SSE2)
+        acc_lo = _mm_sub_epi32(_mm_srli_epi32(acc_lo, 6), bias32);
+        acc_hi = _mm_sub_epi32(_mm_srli_epi32(acc_hi, 6), bias32);
+        __m128i packed = _mm_xor_si128(_mm_packs_epi32(acc_lo, acc_hi), bias16);
+        _mm_storeu_si128((__m128i*)(out + x), packed);
+    }
+    if (x < n) {
+        conv_row_u8_scalar(src + x, weights, taps, out + x, n - x);
+    }
+}
+
+// Indices calculés 8 par 8 (coordonnées élargies en 32 bits puis converties),
+// incréments scalaires dans l'ordre: les doublons d'un groupe s'additionnent
+static void hough_vote_u16_sse2(const int16_t *xs, const int16_t *ys, int n, float c, float s,
+                                int offset, uint16_t *acc) {
+    __m128 vc = _mm_set1_ps(c);
+    __m128 vs = _mm_set1_ps(s);
+    __m128i voffset = _mm_set1_epi32(offset);
+    int32_t idx[8];
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(xs + i));
+        __m128i y = _mm_loadu_si128((const __m128i*)(ys + i));
+        __m128 x_lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+        __m128 x_hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16));
+        __m128 y_lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(y, y), 16));
+        __m128 y_hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(y, y), 16));
+        __m128 rho_lo = _mm_add_ps(_mm_mul_ps(x_lo, vc), _mm_mul_ps(y_lo, vs));
+        __m128 rho_hi = _mm_add_ps(_mm_mul_ps(x_hi, vc), _mm_mul_ps(y_hi, vs));
+        _mm_storeu_si128((__m128i*)idx, _mm_add_epi32(_mm_cvttps_epi32(rho_lo), voffset));
+        _mm_storeu_si128((__m128i*)(idx + 4), _mm_add_epi32(_mm_cvttps_epi32(rho_hi), voffset));
+        for (int k = 0; k < 8; k++) {
+            acc[idx[k]] += (acc[idx[k]] != UINT16_MAX);
+        }
+    }
+    if (i < n) {
+        hough_vote_u16_scalar(xs + i, ys + i, n - i, c, s, offset, acc);
+    }
+}
+
+static void accumulate_u8_sse2(const uint8_t *src, uint16_t *acc, int n) {
+    __m128i zero = _mm_setzero_si128();
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_loadu_si128((const __m128i*)(acc + i));
+        __m128i hi = _mm_loadu_si128((const __m128i*)(acc + i + 8));
+        _mm_storeu_si128((__m128i*)(acc + i), _mm_add_epi16(lo, _mm_unpacklo_epi8(v, zero)));
+        _mm_storeu_si128((__m128i*)(acc + i + 8), _mm_add_epi16(hi, _mm_unpackhi_epi8(v, zero)));
+    }
+    if (i < n) accumulate_u8_scalar(src + i, acc + i, n - i);
+}
+
+// ============================================================================
+// AVX2 + FMA (8 FLOATS)
+// ============================================================================
+
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+
+TARGET_AVX2 static float hsum_avx(__m256 v) {
+    __m128 lo = _mm256_castps256_ps128(v);
+    __m128 hi = _mm256_extractf128_ps(v, 1);
+    return hsum_sse(_mm_add_ps(lo, hi));
+}
+
+TARGET_AVX2 static float dot_avx2(const float *a, const float *b, int n) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+
+    float sum = hsum_avx(_mm256_add_ps(acc0, acc1));
+    for (; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+TARGET_AVX2 static void axpy_avx2(float alpha, const float *x, float *y, int n) {
+    __m256 va = _mm256_set1_ps(alpha);
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(va, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+    for (; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+TARGET_AVX2 static void bias_relu_avx2(float *x, float bias, int n) {
+    __m256 vb = _mm256_set1_ps(bias);
+    __m256 zero = _mm256_setzero_ps();
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(x + i, _mm256_max_ps(_mm256_add_ps(_mm256_loadu_ps(x + i), vb), zero));
+    }
+    for (; i < n; i++) {
+        x[i] = relu(x[i] + bias);
+    }
+}
+
+TARGET_AVX2 static void max_pool2x2_row_avx2(const float *row0, const float *row1, float *out, int out_w) {
+    int i = 0;
+
+    // 16 entrées par ligne -> 8 sorties. shuffle_ps travaille par voie de
+    // 128 bits, d'où la permutation finale pour remettre les sorties en ordre.
+    for (; i + 8 <= out_w; i += 8) {
+        __m256 a = _mm256_max_ps(_mm256_loadu_ps(row0 + 2 * i), _mm256_loadu_ps(row1 + 2 * i));
+        __m256 b = _mm256_max_ps(_mm256_loadu_ps(row0 + 2 * i + 8), _mm256_loadu_ps(row1 + 2 * i + 8));
+        __m256 even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        __m256 odd = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        __m256 m = _mm256_max_ps(even, odd);
+        m = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(m), _MM_SHUFFLE(3, 1, 2, 0)));
+        _mm256_storeu_ps(out + i, m);
+    }
+    if (i < out_w) {
+        max_pool2x2_row_sse2(row0 + 2 * i, row1 + 2 * i, out + i, out_w - i);
+    }
+}
+
+TARGET_AVX2 static int32_t dot_u8s8_avx2(const uint8_t *a, const int8_t *b, int n) {
+    __m256i acc = _mm256_setzero_si256();
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        __m256i va = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(a + i)));
+        __m256i vb = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*)(b + i)));
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(va, vb));
+    }
+
+    __m128i sum4 = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    int32_t sum = hsum_epi32_sse(sum4);
+    for (; i < n; i++) {
+        sum += (int32_t)a[i] * (int32_t)b[i];
+    }
+    return sum;
+}
+
+TARGET_AVX2 static void madd_s16_pairs_avx2(const int16_t *x, int32_t w_pair, int32_t *acc, int n) {
+    __m256i vw = _mm256_set1_epi32(w_pair);
+    int j = 0;
+
+    for (; j + 8 <= n; j += 8) {
+        __m256i prod = _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*)(x + 2 * j)), vw);
+        __m256i *dst = (__m256i*)(acc + j);
+        _mm256_storeu_si256(dst, _mm256_add_epi32(_mm256_loadu_si256(dst), prod));
+    }
+    if (j < n) {
+        madd_s16_pairs_sse2(x + 2 * j, w_pair, acc + j, n - j);
+    }
+}
+
+// 16 sorties par itération; unpack et pack opèrent par voie de 128 bits, les
+// deux se compensent et les sorties restent dans l'ordre
+TARGET_AVX2 static void conv_row_u8_avx2(const uint8_t *src, const int16_t *weights, int taps,
+                                         uint16_t *out, int n) {
+    __m256i round = _mm256_set1_epi32(32);
+    int x = 0;
+
+    for (; x + 16 + 1 <= n; x += 16) {
+        __m256i acc_lo = round;
+        __m256i acc_hi = round;
+        for (int t = 0; t < taps; t += 2) {
+            __m256i p0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(src + x + t)));
+            __m256i p1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(src + x + t + 1)));
+            int16_t w1 = (t + 1 < taps) ? weights[t + 1] : 0;
+            __m256i w = _mm256_set1_epi32((int32_t)(((uint32_t)(uint16_t)w1 << 16) | (uint16_t)weights[t]));
+            acc_lo = _mm256_add_epi32(acc_lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(p0, p1), w));
+            acc_hi = _mm256_add_epi32(acc_hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(p0, p1), w));
+        }
+        __m256i packed = _mm256_packus_epi32(_mm256_srli_epi32(acc_lo, 6), _mm256_srli_epi32(acc_hi, 6));
+        _mm256_storeu_si256((__m256i*)(out + x), packed);
+    }
+    if (x < n) {
+        conv_row_u8_sse2(src + x, weights, taps, out + x, n - x);
+    }
+}
+
+// 16 indices par itération
+TARGET_AVX2 static void hough_vote_u16_avx2(const int16_t *xs, const int16_t *ys, int n, float c,
+                                            float s, int offset, uint16_t *acc) {
+    __m256 vc = _mm256_set1_ps(c);
+    __m256 vs = _mm256_set1_ps(s);
+    __m256i voffset = _mm256_set1_epi32(offset);
+    int32_t idx[16];
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        for (int half = 0; half < 2; half++) {
+            __m256 x = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(xs + i + 8 * half))));
+            __m256 y = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(ys + i + 8 * half))));
+            __m256 rho = _mm256_add_ps(_mm256_mul_ps(x, vc), _mm256_mul_ps(y, vs));
+            _mm256_storeu_si256((__m256i*)(idx + 8 * half),
+                                _mm256_add_epi32(_mm256_cvttps_epi32(rho), voffset));
+        }
+        for (int k = 0; k < 16; k++) {
+            acc[idx[k]] += (acc[idx[k]] != UINT16_MAX);
+        }
+    }
+    if (i < n) {
+        hough_vote_u16_sse2(xs + i, ys + i, n - i, c, s, offset, acc);
+    }
+}
+
+TARGET_AVX2 static void accumulate_u8_avx2(const uint8_t *src, uint16_t *acc, int n) {
+    int i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(src + i)));
+        __m256i a = _mm256_loadu_si256((const __m256i*)(acc + i));
+        _mm256_storeu_si256((__m256i*)(acc + i), _mm256_add_epi16(a, v));
+    }
+    if (i < n) accumulate_u8_sse2(src + i, acc + i, n - i);
+}
+
+// ============================================================================
+// AVX-512 (16 FLOATS)
+// ============================================================================
+
+#define TARGET_AVX512 __attribute__((target("avx512f,avx2,fma")))
+
+TARGET_AVX512 static float dot_avx512(const float *a, const float *b, int n) {
+    __m512 acc = _mm512_setzero_ps();
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc);
+    }
+    if (i < n) {
+        __mmask16 mask = (__mmask16)((1u << (n - i)) - 1);
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i),
+                              _mm512_maskz_loadu_ps(mask, b + i), acc);
+    }
+    return _mm512_reduce_add_ps(acc);
+}
+
+TARGET_AVX512 static void axpy_avx512(float alpha, const float *x, float *y, int n) {
+    __m512 va = _mm512_set1_ps(alpha);
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(y + i, _mm512_fmadd_ps(va, _mm512_loadu_ps(x + i), _mm512_loadu_ps(y + i)));
+    }
+    // Les lignes de convolution sont courtes (8 à 24 floats): une queue en
+    // 256 bits coûte moins cher qu'un store masqué
+    if (i < n) {
+        axpy_avx2(alpha, x + i, y + i, n - i);
+    }
+}
+
+TARGET_AVX512 static void bias_relu_avx512(float *x, float bias, int n) {
+    __m512 vb = _mm512_set1_ps(bias);
+    __m512 zero = _mm512_setzero_ps();
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        _mm512_storeu_ps(x + i, _mm512_max_ps(_mm512_add_ps(_mm512_loadu_ps(x + i), vb), zero));
+    }
+    if (i < n) {
+        bias_relu_avx2(x + i, bias, n - i);
+    }
+}
+
+TARGET_AVX512 static void softmax_avx512(const float *input, float *output, int n) {
+    __m512 vmax = _mm512_set1_ps(-INFINITY);
+    int i = 0;
+
+    for (; i + 16 <= n; i += 16) {
+        vmax = _mm512_max_ps(vmax, _mm512_loadu_ps(input + i));
+    }
+    if (i < n) {
+        __mmask16 mask = (__mmask16)((1u << (n - i)) - 1);
+        vmax = _mm512_mask_max_ps(vmax, mask, vmax, _mm512_maskz_loadu_ps(mask, input + i));
+    }
+
+    softmax_with_max(input, output, n, _mm512_reduce_max_ps(vmax));
+}
+
+#endif // SIMD_X86
+
+// ============================================================================
+// TABLES ET SÉLECTION
+// ============================================================================
+
+static const SimdKernels kernels_scalar = {
+    SIMD_LEVEL_SCALAR, "scalar",
+    dot_scalar, axpy_scalar, bias_relu_scalar, max_pool2x2_row_scalar, softmax_scalar,
+    dot_u8s8_scalar, madd_s16_pairs_scalar, conv_row_u8_scalar, hough_vote_u16_scalar,
+    accumulate_u8_scalar
+};
+
+#ifdef SIMD_X86
+static const SimdKernels kernels_sse2 = {
+    SIMD_LEVEL_SSE2, "sse2",
+    dot_sse2, axpy_sse2, bias_relu_sse2, max_pool2x2_row_sse2, softmax_sse2,
+    dot_u8s8_sse2, madd_s16_pairs_sse2, conv_row_u8_sse2, hough_vote_u16_sse2,
+    accumulate_u8_sse2
+};
+
+// Le softmax ne porte que sur 10 valeurs: la version SSE2 suffit en AVX2
+static const SimdKernels kernels_avx2 = {
+    SIMD_LEVEL_AVX2, "avx2+fma",
+    dot_avx2, axpy_avx2, bias_relu_avx2, max_pool2x2_row_avx2, softmax_sse2,
+    dot_u8s8_avx2, madd_s16_pairs_avx2, conv_row_u8_avx2, hough_vote_u16_avx2,
+    accumulate_u8_avx2
+};
+
+// Le pooling et les noyaux entiers réutilisent AVX2 (toujours présent avec
+// AVX-512F sur les CPU réels; les entiers 512 bits demanderaient AVX-512BW)
+static const SimdKernels kernels_avx512 = {
+    SIMD_LEVEL_AVX512, "avx512f",
+    dot_avx512, axpy_avx512, bias_relu_avx512, max_pool2x2_row_avx2, softmax_avx512,
+    dot_u8s8_avx2, madd_s16_pairs_avx2, conv_row_u8_avx2, hough_vote_u16_avx2,
+    accumulate_u8_avx2
+};
+#endif
+
+static const SimdKernels *active_kernels = NULL;
+
+SimdLevel simd_detect_level(void) {
+#ifdef SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx2") &&
+        __builtin_cpu_supports("fma")) {
+        return SIMD_LEVEL_AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SIMD_LEVEL_AVX2;
+    }
+    return SIMD_LEVEL_SSE2;
+#else
+    return SIMD_LEVEL_SCALAR;
+#endif
+}
+
+SimdLevel simd_select_level(SimdLevel max_level) {
+    SimdLevel level = simd_detect_level();
+    if (max_level < level) level = max_level;
+
+    switch (level) {
+#ifdef SIMD_X86
+        case SIMD_LEVEL_AVX512: active_kernels = &kernels_avx512; break;
+        case SIMD_LEVEL_AVX2:   active_kernels = &kernels_avx2; break;
+        case SIMD_LEVEL_SSE2:   active_kernels = &kernels_sse2; break;
+#endif
+        default:
+            active_kernels = &kernels_scalar;
+            level = SIMD_LEVEL_SCALAR;
+            break;
+    }
+
+    LOG_DEBUG("Noyaux SIMD sélectionnés: %s", active_kernels->name);
+    return level;
+}
+
+const SimdKernels* simd_kernels(void) {
+    if (!active_kernels) {
+        simd_select_level(SIMD_LEVEL_AVX512);
+    }
+    return active_kernels;
+}
@@ -0,0 +1,78 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// NOYAUX VECTORISÉS (SÉLECTION À L'EXÉCUTION)
+// ============================================================================
+//
+// Le binaire est compilé pour la cible x86-64 de base (SSE2). Les variantes
+// AVX2+FMA et AVX-512 sont compilées via des attributs target() et choisies
+// une seule fois au démarrage d'après cpuid, de sorte qu'un même binaire
+// fonctionne partout et exploite les vecteurs disponibles sur chaque machine.
+
+// Niveaux de jeu d'instructions, du plus simple au plus large
+typedef enum {
+    SIMD_LEVEL_SCALAR,      // C portable (architectures non x86)
+    SIMD_LEVEL_SSE2,        // 4 floats (base x86-64)
+    SIMD_LEVEL_AVX2,        // 8 floats + FMA
+    SIMD_LEVEL_AVX512       // 16 floats + FMA + masques
+} SimdLevel;
+
+// Table des noyaux utilisés par le CNN et le prétraitement
+typedef struct {
+    SimdLevel level;
+    const char *name;
+
+    // Produit scalaire de deux vecteurs de n floats
+    float (*dot)(const float *a, const float *b, int n);
+
+    // y[i] += alpha * x[i]
+    void (*axpy)(float alpha, const float *x, float *y, int n);
+
+    // x[i] = max(x[i] + bias, 0)
+    void (*bias_relu)(float *x, float bias, int n);
+
+    // Max pooling 2x2 d'une paire de lignes: out[i] = max des 4 valeurs
+    // row0[2i], row0[2i+1], row1[2i], row1[2i+1]
+    void (*max_pool2x2_row)(const float *row0, const float *row1, float *out, int out_w);
+
+    // Softmax numériquement stable (max soustrait avant exp)
+    void (*softmax)(const float *input, float *output, int n);
+
+    // Produit scalaire entier uint8 x int8 accumulé en int32 (inférence int8).
+    // Les opérandes sont élargis en 16 bits avant multiplication: pas de saturation.
+    int32_t (*dot_u8s8)(const uint8_t *a, const int8_t *b, int n);
+
+    // acc[j] += x[2j] * w0 + x[2j+1] * w1 sur n sorties, avec w_pair = (w1 << 16) | w0
+    // (paires int16 entrelacées: deux lignes de patch im2col traitées par un madd)
+    void (*madd_s16_pairs)(const int16_t *x, int32_t w_pair, int32_t *acc, int n);
+
+    // Convolution horizontale d'une ligne 8 bits par des poids Q14 (somme 16384):
+    // out[x] = (sum_t weights[t] * src[x + t] + 32) >> 6, en Q8, pour x dans [0, n)
+    // (src doit contenir n + taps - 1 pixels)
+    void (*conv_row_u8)(const uint8_t *src, const int16_t *weights, int taps, uint16_t *out, int n);
+
+    // Votes de Hough de n points pour un theta: acc[rho + offset] += 1 (saturé à
+    // 65535) avec rho = (int)(xs[i] * c + ys[i] * s), calcul en float et
+    // troncature comme en C; offset doit garder tous les indices dans acc
+    void (*hough_vote_u16)(const int16_t *xs, const int16_t *ys, int n, float c, float s,
+                           int offset, uint16_t *acc);
+
+    // acc[i] += src[i] sur n valeurs (sommes de lignes des réductions par blocs)
+    void (*accumulate_u8)(const uint8_t *src, uint16_t *acc, int n);
+} SimdKernels;
+
+// Retourne la table sélectionnée (détection cpuid au premier appel)
+const SimdKernels* simd_kernels(void);
+
+// Meilleur niveau supporté par le processeur courant
+SimdLevel simd_detect_level(void);
+
+// Force un niveau (borné par ce que supporte le CPU), pour les benchmarks
+// Returns: le niveau effectivement retenu
+SimdLevel simd_select_level(SimdLevel max_level);
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utils.h"
+#include "sudoku_solver.h"
+#include "sudoku_batch.h"
+
+// Résout une banque de grilles (une grille de 81 caractères par ligne)
+int main(int argc, char *argv[]) {
+    if (argc > 1 && (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0)) {
+        printf("Usage: %s [input|-] [output|-] [threads]\n", argv[0]);
+        printf("Exemple: %s puzzles.txt solutions.txt 8\n", argv[0]);
+        printf("Moteur: SUDOKU_ENGINE=bitmask|dlx|backtrack\n");
+        printf("Code de sortie: 0 si toutes les grilles sont résolues, 2 si au moins une\n"
+               "est insoluble ou invalide, 1 en cas d'erreur (fichier, moteur, mémoire)\n");
+        return 0;
+    }
+
+    const char *input_path = (argc > 1) ? argv[1] : "-";
+    const char *output_path = (argc > 2) ? argv[2] : "-";
+    int num_threads = (argc > 3) ? atoi(argv[3]) : 0;
+
+    const char *engine_name = getenv("SUDOKU_ENGINE");
+    SolverEngine engine;
+    if (engine_name) {
+        if (!sudoku_engine_from_name(engine_name, &engine)) {
+            LOG_ERROR("Moteur inconnu: %s (bitmask|dlx|backtrack)", engine_name);
+            return 1;
+        }
+        sudoku_set_engine(engine);
+    }
+
+    FILE *in = strcmp(input_path, "-") == 0 ? stdin : fopen(input_path, "r");
+    if (!in) {
+        LOG_ERROR("Impossible d'ouvrir %s", input_path);
+        return 1;
+    }
+    FILE *out = strcmp(output_path, "-") == 0 ? stdout : fopen(output_path, "w");
+    if (!out) {
+        LOG_ERROR("Impossible d'écrire %s", output_path);
+        if (in != stdin) fclose(in);
+        return 1;
+    }
+
+    BatchStats stats;
+    bool ok = sudoku_solve_stream(in, out, num_threads, &stats);
+
+    if (in != stdin) fclose(in);
+    if (out != stdout) fclose(out);
+    else fflush(out);
+
+    if (!ok) {
+        LOG_ERROR("Allocation impossible");
+        return 1;
+    }
+
+    // Statistiques sur stderr pour ne pas mélanger avec les solutions
+    fprintf(stderr, "%zu grilles (%zu résolues, %zu insolubles, %zu invalides) en %.3f s: %.0f grilles/s [moteur %s]\n",
+            stats.total, stats.solved, stats.unsolvable, stats.invalid, stats.seconds,
+            stats.seconds > 0 ? stats.total / stats.seconds : 0.0,
+            sudoku_engine_name(sudoku_get_engine()));
+    return (stats.unsolvable + stats.invalid) > 0 ? 2 : 0;
+}
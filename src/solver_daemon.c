@@ -0,0 +1,489 @@
+#define _POSIX_C_SOURCE 200809L  // sigaction, clock_gettime
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "utils.h"
+#include "image_loader.h"
+#include "cnn_model.h"
+#include "simd_kernels.h"
+#include "sudoku_pipeline.h"
+#include "sudoku_solver.h"
+#include "worker_pool.h"
+#include "trace.h"
+
+// ============================================================================
+// DÉMON DE RÉSOLUTION (SOCKET UNIX)
+// ============================================================================
+//
+// Charge les poids une seule fois puis traite des requêtes sur une socket Unix,
+// une requête par connexion. Entiers en u32 little-endian.
+//
+// Le thread principal accepte les connexions et lit les requêtes sans bloquer
+// (poll), chacune avec un délai maximal: un client lent ou muet n'occupe
+// jamais un worker. Chaque requête complète passe par un pool de workers (un
+// InferenceContext par worker) via une file bornée: file pleine ou attente
+// trop longue donnent immédiatement une réponse DAEMON_STATUS_OVERLOADED.
+// Les demandes de métriques sont servies par le thread principal, hors file:
+// elles restent disponibles en surcharge.
+// Réglages (variables d'environnement):
+//   SOLVER_WORKERS        nombre de workers (défaut: nombre de CPU)
+//   SOLVER_QUEUE_DEPTH    requêtes en attente max (défaut: 4 par worker)
+//   SOLVER_QUEUE_AGE_MS   attente max avant délestage (défaut: 5000)
+//   SOLVER_READ_TIMEOUT_MS délai de lecture d'une requête (défaut: 2000)
+//   SOLVER_PIN_WORKERS    1 pour fixer chaque worker sur un CPU
+//   SUDOKU_ENGINE         moteur de résolution: bitmask (défaut), dlx, backtrack
+//   CNN_CONV_ALGO         convolution: im2col (défaut), direct
+//   CNN_SIMD              plafond des noyaux: scalar, sse2, avx2, avx512
+//   (valeur inconnue pour ces trois réglages: arrêt au démarrage)
+//   SUDOKU_THRESHOLD      binarisation: otsu (défaut), mean-c, sauvola
+//
+// Requête:  magic "SDKQ" | flags | taille image | image (fichier PNG/JPG complet)
+//           flags bit 0: renvoyer l'image résolue en PNG
+//           flags bit 1: demande de métriques (taille image 0)
+// Réponse:  magic "SDKR" | statut | taille PNG | 81 octets indices
+//           | 81 octets solution | PNG
+//           statut: PipelineStatus (0 = OK), ou DAEMON_STATUS_* pour une
+//           requête rejetée avant traitement
+//           Pour une demande de métriques, le PNG est remplacé par les
+//           traces au format texte Prometheus (grilles à zéro)
+
+#define REQUEST_MAGIC       0x514B4453u  // "SDKQ"
+#define RESPONSE_MAGIC      0x524B4453u  // "SDKR"
+#define FLAG_WANT_PNG       0x1u
+#define FLAG_METRICS        0x2u
+#define MAX_IMAGE_SIZE      (32u * 1024 * 1024)
+#define CLIENT_TIMEOUT_SEC  10      // Envoi de la réponse
+#define MAX_PENDING_READS   64      // Requêtes en cours de lecture
+
+#define DAEMON_STATUS_BAD_REQUEST 100
+#define DAEMON_STATUS_OVERLOADED  101
+
+static volatile sig_atomic_t stop_requested = 0;
+
+// Binarisation choisie au démarrage (SUDOKU_THRESHOLD), en lecture seule ensuite
+static PipelineThreshold daemon_threshold = PIPELINE_THRESHOLD_OTSU;
+
+static void handle_stop_signal(int sig) {
+    (void)sig;
+    stop_requested = 1;
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+static void put_u32(uint8_t *dst, uint32_t value) {
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+    dst[2] = (uint8_t)(value >> 16);
+    dst[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *src) {
+    return (uint32_t)src[0] | ((uint32_t)src[1] << 8) |
+           ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+}
+
+static bool write_full(int fd, const void *buffer, size_t size) {
+    const uint8_t *src = (const uint8_t*)buffer;
+    while (size > 0) {
+        ssize_t n = write(fd, src, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        src += n;
+        size -= (size_t)n;
+    }
+    return true;
+}
+
+static bool send_response(int fd, uint32_t status, const PipelineResult *result,
+                          const uint8_t *png, size_t png_size) {
+    uint8_t header[12 + 81 + 81];
+    put_u32(header, RESPONSE_MAGIC);
+    put_u32(header + 4, status);
+    put_u32(header + 8, (uint32_t)png_size);
+
+    for (int i = 0; i < 81; i++) {
+        header[12 + i] = result ? (uint8_t)result->clues[i] : 0;
+        header[12 + 81 + i] = result ? (uint8_t)result->solution[i] : 0;
+    }
+
+    if (!write_full(fd, header, sizeof(header))) return false;
+    return png_size == 0 || write_full(fd, png, png_size);
+}
+
+// Répond à une demande de métriques
+static bool send_metrics(int fd) {
+    char *text = NULL;
+    size_t text_size = 0;
+    FILE *out = open_memstream(&text, &text_size);
+    if (!out) return send_response(fd, PIPELINE_ERR_MEMORY, NULL, NULL, 0);
+
+    trace_write_prometheus(out);
+    fclose(out);
+
+    bool sent = send_response(fd, PIPELINE_OK, NULL, (const uint8_t*)text, text_size);
+    free(text);
+    return sent;
+}
+
+// ============================================================================
+// LECTURE DES REQUÊTES
+// ============================================================================
+
+// Requête complète, traitée par un worker
+typedef struct {
+    int fd;
+    uint32_t flags;
+    uint8_t *image_data;
+    uint32_t image_size;
+} RequestJob;
+
+// Requête en cours de lecture (socket non bloquante)
+typedef struct {
+    int fd;
+    uint8_t header[12];
+    size_t received;            // Octets reçus (en-tête puis image)
+    uint32_t flags;
+    uint8_t *image_data;
+    uint32_t image_size;
+    double deadline_ms;
+} PendingRead;
+
+typedef enum {
+    READ_PENDING,               // Données attendues
+    READ_COMPLETE,              // Requête entière reçue
+    READ_CLOSED,                // EOF ou erreur: fermer sans répondre
+    READ_INVALID,               // En-tête invalide: DAEMON_STATUS_BAD_REQUEST
+    READ_NO_MEMORY              // Image impossible à allouer
+} ReadProgress;
+
+// Lit tout ce qui est disponible sans bloquer
+static ReadProgress read_progress(PendingRead *p) {
+    for (;;) {
+        uint8_t *dst;
+        size_t wanted;
+        if (p->received < sizeof(p->header)) {
+            dst = p->header + p->received;
+            wanted = sizeof(p->header) - p->received;
+        } else {
+            size_t done = p->received - sizeof(p->header);
+            if (done == p->image_size) return READ_COMPLETE;
+            dst = p->image_data + done;
+            wanted = p->image_size - done;
+        }
+
+        ssize_t n = read(p->fd, dst, wanted);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return READ_PENDING;
+        if (n <= 0) return READ_CLOSED;
+        p->received += (size_t)n;
+        if (p->received != sizeof(p->header)) continue;
+
+        uint32_t magic = get_u32(p->header);
+        p->flags = get_u32(p->header + 4);
+        p->image_size = get_u32(p->header + 8);
+        if (magic == REQUEST_MAGIC && (p->flags & FLAG_METRICS) && p->image_size == 0) {
+            return READ_COMPLETE;
+        }
+        if (magic != REQUEST_MAGIC || p->image_size == 0 || p->image_size > MAX_IMAGE_SIZE) {
+            LOG_ERROR("Requête invalide (magic 0x%08x, %u octets)", magic, p->image_size);
+            return READ_INVALID;
+        }
+        p->image_data = (uint8_t*)malloc(p->image_size);
+        if (!p->image_data) return READ_NO_MEMORY;
+    }
+}
+
+static void free_request(RequestJob *request) {
+    close(request->fd);
+    free(request->image_data);
+    free(request);
+}
+
+// ============================================================================
+// WORKERS
+// ============================================================================
+
+// Traite une requête complète et envoie la réponse
+static void handle_request(const RequestJob *request, const CNNModel *model,
+                           InferenceContext *ctx) {
+    double start = now_ms();
+    uint64_t t = trace_begin();
+    RGBImage *image = load_rgb_image_from_memory(request->image_data, request->image_size);
+    trace_end(TRACE_LOAD, t);
+
+    PipelineOptions options = pipeline_default_options();
+    options.compose_output = (request->flags & FLAG_WANT_PNG) != 0;
+    options.threshold = daemon_threshold;
+
+    PipelineResult result;
+    PipelineStatus status = image ? sudoku_pipeline_run(model, ctx, image, &options, &result)
+                                  : PIPELINE_ERR_IMAGE;
+    rgb_image_free(image);
+
+    uint8_t *png = NULL;
+    size_t png_size = 0;
+    if (status == PIPELINE_OK && result.output) {
+        png = encode_rgb_png(result.output, &png_size);
+    }
+
+    send_response(request->fd, status, status == PIPELINE_OK ? &result : NULL, png, png_size);
+
+    LOG_INFO("Requête: %s (%.1f ms, image %u octets)",
+             pipeline_status_message(status), now_ms() - start, request->image_size);
+
+    free(png);
+    if (status == PIPELINE_OK) pipeline_result_free(&result);
+}
+
+static void* worker_init(int worker_id, void *user_data) {
+    (void)worker_id;
+    return create_inference_context((const CNNModel*)user_data, 81);
+}
+
+static void worker_free(void *worker_state, void *user_data) {
+    (void)user_data;
+    free_inference_context((InferenceContext*)worker_state);
+}
+
+static void worker_handle(void *worker_state, void *job, void *user_data) {
+    RequestJob *request = (RequestJob*)job;
+    InferenceContext *ctx = (InferenceContext*)worker_state;
+
+    if (ctx) {
+        handle_request(request, (const CNNModel*)user_data, ctx);
+    } else {
+        send_response(request->fd, PIPELINE_ERR_MEMORY, NULL, NULL, 0);
+    }
+    free_request(request);
+}
+
+// Requête refusée ou délestée: réponse immédiate sans traitement
+static void reject_request(void *job, void *user_data) {
+    (void)user_data;
+    RequestJob *request = (RequestJob*)job;
+    send_response(request->fd, DAEMON_STATUS_OVERLOADED, NULL, NULL, 0);
+    free_request(request);
+}
+
+// Termine une lecture: métriques, soumission de la requête, erreur ou abandon
+static void finish_read(PendingRead *p, ReadProgress progress, WorkerPool *pool) {
+    if (progress == READ_COMPLETE && (p->flags & FLAG_METRICS)) {
+        // Quelques Ko: tiennent dans le tampon d'envoi de la socket
+        send_metrics(p->fd);
+        close(p->fd);
+        return;
+    }
+
+    if (progress == READ_COMPLETE) {
+        RequestJob *request = (RequestJob*)malloc(sizeof(RequestJob));
+        if (request) {
+            // Réponse écrite par le worker en mode bloquant, avec délai
+            struct timeval timeout = {CLIENT_TIMEOUT_SEC, 0};
+            fcntl(p->fd, F_SETFL, fcntl(p->fd, F_GETFL) & ~O_NONBLOCK);
+            setsockopt(p->fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+            request->fd = p->fd;
+            request->flags = p->flags;
+            request->image_data = p->image_data;
+            request->image_size = p->image_size;
+
+            // Admission: file pleine -> "surchargé" immédiatement
+            if (!worker_pool_submit(pool, request)) reject_request(request, NULL);
+            return;
+        }
+        progress = READ_NO_MEMORY;
+    }
+
+    if (progress == READ_INVALID) {
+        send_response(p->fd, DAEMON_STATUS_BAD_REQUEST, NULL, NULL, 0);
+    } else if (progress == READ_NO_MEMORY) {
+        send_response(p->fd, PIPELINE_ERR_MEMORY, NULL, NULL, 0);
+    } else if (progress == READ_PENDING) {
+        LOG_ERROR("Requête incomplète à l'expiration du délai de lecture (%zu octets)", p->received);
+    }
+    close(p->fd);
+    free(p->image_data);
+}
+
+static int env_int(const char *name, int default_value) {
+    const char *value = getenv(name);
+    return value ? atoi(value) : default_value;
+}
+
+static int open_listen_socket(const char *path) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        LOG_ERROR("Chemin de socket trop long: %s", path);
+        return -1;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        LOG_ERROR("socket(): %s", strerror(errno));
+        return -1;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    unlink(path);  // Socket laissée par une exécution précédente
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 64) != 0) {
+        LOG_ERROR("Impossible d'écouter sur %s: %s", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <socket_path> [weights_path]\n", argv[0]);
+        return 1;
+    }
+
+    const char *socket_path = argv[1];
+    const char *weights_path = (argc > 2) ? argv[2] : "models/cnn_weights.bin";
+
+    // Sélection des noyaux et du moteur avant le démarrage des threads
+    if (!pipeline_configure_engines_from_env()) return 1;
+
+    // Poids projetés sans copie; l'ancien format CNNW passe par une copie
+    CNNModel *model = map_cnn_model(weights_path);
+    if (!model) {
+        model = create_cnn_model();
+        if (!load_cnn_weights(model, weights_path)) {
+            LOG_ERROR("Poids introuvables, poids aléatoires (tests uniquement)");
+        }
+    }
+
+    const char *threshold_name = getenv("SUDOKU_THRESHOLD");
+    if (threshold_name && !pipeline_threshold_from_name(threshold_name, &daemon_threshold)) {
+        LOG_ERROR("Binarisation inconnue: %s (otsu|mean-c|sauvola)", threshold_name);
+    }
+    LOG_INFO("Convolution: %s, noyaux CNN: %s, moteur de résolution: %s, binarisation: %s",
+             (cnn_get_conv_algorithm() == CONV_ALGO_DIRECT) ? "direct" : "im2col",
+             simd_kernels()->name, sudoku_engine_name(sudoku_get_engine()),
+             pipeline_threshold_name(daemon_threshold));
+
+    WorkerPoolConfig config;
+    config.num_workers = max_int(1, env_int("SOLVER_WORKERS", worker_pool_cpu_count()));
+    config.queue_capacity = max_int(1, env_int("SOLVER_QUEUE_DEPTH", 4 * config.num_workers));
+    config.max_queue_age_ms = env_int("SOLVER_QUEUE_AGE_MS", 5000);
+    config.pin_workers = env_int("SOLVER_PIN_WORKERS", 0) != 0;
+    int read_timeout_ms = max_int(1, env_int("SOLVER_READ_TIMEOUT_MS", 2000));
+
+    // Les workers héritent d'un masque bloquant SIGINT/SIGTERM: le signal
+    // arrive toujours au thread principal et interrompt poll()
+    sigset_t stop_signals, previous_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &previous_mask);
+
+    int listen_fd = open_listen_socket(socket_path);
+    WorkerPool *pool = (listen_fd >= 0)
+                       ? worker_pool_create(&config, worker_init, worker_free,
+                                            worker_handle, reject_request, model)
+                       : NULL;
+    pthread_sigmask(SIG_SETMASK, &previous_mask, NULL);
+    if (!pool) {
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            unlink(socket_path);
+        }
+        free_cnn_model(model);
+        return 1;
+    }
+
+    // Pas de SA_RESTART: poll() est interrompu pour permettre l'arrêt
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);  // Client parti: write() renvoie EPIPE
+
+    LOG_INFO("Démon prêt sur %s", socket_path);
+
+    // Lectures en cours: entrée 0 = socket d'écoute, tant qu'il reste de la place
+    PendingRead pending[MAX_PENDING_READS];
+    struct pollfd fds[MAX_PENDING_READS + 1];
+    int num_pending = 0;
+
+    while (!stop_requested) {
+        bool accepting = num_pending < MAX_PENDING_READS;
+        int first = accepting ? 1 : 0;
+        if (accepting) fds[0] = (struct pollfd){listen_fd, POLLIN, 0};
+
+        double now = now_ms();
+        int timeout_ms = -1;
+        for (int i = 0; i < num_pending; i++) {
+            fds[first + i] = (struct pollfd){pending[i].fd, POLLIN, 0};
+            int remaining = max_int(0, (int)(pending[i].deadline_ms - now) + 1);
+            if (timeout_ms < 0 || remaining < timeout_ms) timeout_ms = remaining;
+        }
+
+        if (poll(fds, (nfds_t)(first + num_pending), timeout_ms) < 0) {
+            if (errno != EINTR) LOG_ERROR("poll(): %s", strerror(errno));
+            continue;
+        }
+
+        // De la fin vers le début: l'entrée déplacée sur i est déjà traitée
+        now = now_ms();
+        for (int i = num_pending - 1; i >= 0; i--) {
+            ReadProgress progress = fds[first + i].revents ? read_progress(&pending[i])
+                                                           : READ_PENDING;
+            if (progress == READ_PENDING && now < pending[i].deadline_ms) continue;
+            finish_read(&pending[i], progress, pool);
+            pending[i] = pending[--num_pending];
+        }
+
+        if (accepting && (fds[0].revents & POLLIN)) {
+            int fd = accept(listen_fd, NULL, NULL);
+            if (fd < 0) {
+                if (errno != EINTR) LOG_ERROR("accept(): %s", strerror(errno));
+                continue;
+            }
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+            PendingRead *p = &pending[num_pending++];
+            memset(p, 0, sizeof(*p));
+            p->fd = fd;
+            p->deadline_ms = now_ms() + read_timeout_ms;
+        }
+    }
+
+    for (int i = 0; i < num_pending; i++) {
+        close(pending[i].fd);
+        free(pending[i].image_data);
+    }
+
+    LOG_INFO("Arrêt du démon");
+    close(listen_fd);
+    unlink(socket_path);
+
+    WorkerPoolStats stats = worker_pool_stats(pool);
+    LOG_INFO("Requêtes: %zu acceptées, %zu traitées, %zu refusées, %zu délestées",
+             stats.submitted, stats.completed, stats.rejected, stats.shed);
+
+    worker_pool_destroy(pool);
+    free_cnn_model(model);
+    return 0;
+}
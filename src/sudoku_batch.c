@@ -0,0 +1,238 @@
+#define _POSIX_C_SOURCE 200809L  // getline, clock_gettime
+
+#include "sudoku_batch.h"
+#include "sudoku_solver.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define BATCH_BLOCK_SIZE 65536  // Grilles lues puis résolues ensemble
+#define OWNER_CHUNK      16     // Grilles prises à la fois sur sa propre plage
+
+// Plage restante d'un thread; le propriétaire prend par le début, les
+// voleurs par la fin
+typedef struct {
+    pthread_mutex_t lock;
+    size_t begin;
+    size_t end;
+    char padding[64];           // Une plage par ligne de cache
+} WorkRange;
+
+typedef struct {
+    uint8_t *grids;
+    uint8_t *status;
+    WorkRange *ranges;
+    int num_threads;
+    int id;
+    pthread_t thread;
+} BatchWorker;
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+bool sudoku_parse_line(const char *line, size_t length, uint8_t cells[81]) {
+    if (length != 81) return false;
+    for (int i = 0; i < 81; i++) {
+        char c = line[i];
+        if (c >= '1' && c <= '9') cells[i] = (uint8_t)(c - '0');
+        else if (c == '0' || c == '.') cells[i] = 0;
+        else return false;
+    }
+    return true;
+}
+
+void sudoku_format_cells(const uint8_t cells[81], char text[81]) {
+    for (int i = 0; i < 81; i++) {
+        text[i] = cells[i] ? (char)('0' + cells[i]) : '.';
+    }
+}
+
+static void solve_range(BatchWorker *worker, size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+        if (worker->status[i] == BATCH_INVALID) continue;
+        bool solved = sudoku_solve_cells(worker->grids + i * 81, NULL);
+        worker->status[i] = solved ? BATCH_SOLVED : BATCH_UNSOLVABLE;
+    }
+}
+
+// Prend un bloc au début de sa propre plage. Returns: false si elle est vide
+static bool take_own(WorkRange *range, size_t *begin, size_t *end) {
+    pthread_mutex_lock(&range->lock);
+    bool found = range->begin < range->end;
+    if (found) {
+        *begin = range->begin;
+        *end = range->begin + OWNER_CHUNK < range->end ? range->begin + OWNER_CHUNK : range->end;
+        range->begin = *end;
+    }
+    pthread_mutex_unlock(&range->lock);
+    return found;
+}
+
+// Vole la seconde moitié de la plage d'un autre thread et en fait sa plage
+// Returns: false si toutes les plages sont vides
+static bool steal(BatchWorker *worker) {
+    for (int k = 1; k < worker->num_threads; k++) {
+        WorkRange *victim = &worker->ranges[(worker->id + k) % worker->num_threads];
+
+        pthread_mutex_lock(&victim->lock);
+        size_t remaining = victim->end - victim->begin;
+        size_t stolen_begin = victim->end - remaining / 2;
+        size_t stolen_end = victim->end;
+        if (remaining >= 2) victim->end = stolen_begin;
+        pthread_mutex_unlock(&victim->lock);
+
+        if (remaining >= 2) {
+            WorkRange *own = &worker->ranges[worker->id];
+            pthread_mutex_lock(&own->lock);
+            own->begin = stolen_begin;
+            own->end = stolen_end;
+            pthread_mutex_unlock(&own->lock);
+            return true;
+        }
+    }
+    // Il reste au plus une grille par plage, traitée par son propriétaire
+    return false;
+}
+
+static void* batch_worker_main(void *arg) {
+    BatchWorker *worker = (BatchWorker*)arg;
+    size_t begin, end;
+
+    for (;;) {
+        while (take_own(&worker->ranges[worker->id], &begin, &end)) {
+            solve_range(worker, begin, end);
+        }
+        if (!steal(worker)) break;
+    }
+    return NULL;
+}
+
+static int default_thread_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+}
+
+void sudoku_solve_batch(uint8_t *grids, uint8_t *status, size_t count, int num_threads) {
+    if (count == 0) return;
+    if (num_threads <= 0) num_threads = default_thread_count();
+    if ((size_t)num_threads > count) num_threads = (int)count;
+
+    WorkRange *ranges = (WorkRange*)calloc(num_threads, sizeof(WorkRange));
+    BatchWorker *workers = (BatchWorker*)calloc(num_threads, sizeof(BatchWorker));
+    if (!ranges || !workers || num_threads == 1) {
+        // Un seul thread (ou plus de mémoire): résolution séquentielle
+        BatchWorker single = {.grids = grids, .status = status, .num_threads = 1};
+        solve_range(&single, 0, count);
+        free(ranges);
+        free(workers);
+        return;
+    }
+
+    // Découpage initial en plages égales
+    for (int t = 0; t < num_threads; t++) {
+        pthread_mutex_init(&ranges[t].lock, NULL);
+        ranges[t].begin = count * t / num_threads;
+        ranges[t].end = count * (t + 1) / num_threads;
+    }
+
+    int started = 0;
+    for (int t = 0; t < num_threads; t++) {
+        workers[t].grids = grids;
+        workers[t].status = status;
+        workers[t].ranges = ranges;
+        workers[t].num_threads = num_threads;
+        workers[t].id = t;
+        if (t > 0 && pthread_create(&workers[t].thread, NULL, batch_worker_main, &workers[t]) != 0) {
+            LOG_ERROR("Impossible de démarrer le thread %d", t);
+            break;  // Ses grilles seront volées par les autres
+        }
+        started = t + 1;
+    }
+
+    // Le thread appelant travaille aussi
+    batch_worker_main(&workers[0]);
+
+    for (int t = 1; t < started; t++) {
+        pthread_join(workers[t].thread, NULL);
+    }
+    // Plages de threads non démarrés ou dernières grilles non volables
+    for (int t = 0; t < num_threads; t++) {
+        solve_range(&workers[0], ranges[t].begin, ranges[t].end);
+        pthread_mutex_destroy(&ranges[t].lock);
+    }
+
+    free(ranges);
+    free(workers);
+}
+
+// Résout un bloc et écrit les résultats dans l'ordre
+static void flush_block(FILE *out, uint8_t *grids, uint8_t *status, size_t count,
+                        int num_threads, BatchStats *stats) {
+    sudoku_solve_batch(grids, status, count, num_threads);
+
+    char line[82];
+    line[81] = '\n';
+    for (size_t i = 0; i < count; i++) {
+        switch (status[i]) {
+            case BATCH_SOLVED:
+                sudoku_format_cells(grids + i * 81, line);
+                fwrite(line, 1, sizeof(line), out);
+                stats->solved++;
+                break;
+            case BATCH_UNSOLVABLE:
+                fputs("unsolvable\n", out);
+                stats->unsolvable++;
+                break;
+            default:
+                fputs("invalid\n", out);
+                stats->invalid++;
+                break;
+        }
+    }
+}
+
+bool sudoku_solve_stream(FILE *in, FILE *out, int num_threads, BatchStats *stats) {
+    memset(stats, 0, sizeof(BatchStats));
+    double start = monotonic_seconds();
+
+    uint8_t *grids = (uint8_t*)malloc((size_t)BATCH_BLOCK_SIZE * 81);
+    uint8_t *status = (uint8_t*)malloc(BATCH_BLOCK_SIZE);
+    if (!grids || !status) {
+        free(grids);
+        free(status);
+        return false;
+    }
+
+    char *line = NULL;
+    size_t capacity = 0;
+    ssize_t length;
+    size_t count = 0;
+
+    while ((length = getline(&line, &capacity, in)) != -1) {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r')) length--;
+        if (length == 0 || line[0] == '#') continue;
+
+        bool parsed = sudoku_parse_line(line, (size_t)length, grids + count * 81);
+        status[count] = parsed ? BATCH_SOLVED : BATCH_INVALID;
+        count++;
+        stats->total++;
+
+        if (count == BATCH_BLOCK_SIZE) {
+            flush_block(out, grids, status, count, num_threads, stats);
+            count = 0;
+        }
+    }
+    if (count > 0) flush_block(out, grids, status, count, num_threads, stats);
+
+    free(line);
+    free(grids);
+    free(status);
+    stats->seconds = monotonic_seconds() - start;
+    return true;
+}
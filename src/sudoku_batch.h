@@ -0,0 +1,56 @@
+#ifndef SUDOKU_BATCH_H
+#define SUDOKU_BATCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ============================================================================
+// RÉSOLUTION PAR LOTS (BANQUES DE GRILLES)
+// ============================================================================
+//
+// Résout des grilles sans OCR, au format compact de 81 octets (0 = vide), sur
+// plusieurs threads. Chaque thread reçoit une plage contiguë de grilles et la
+// consomme par petits blocs; un thread sans travail vole la moitié restante
+// de la plage d'un autre (vol de travail), ce qui équilibre les grilles
+// difficiles sans file centrale. Les solutions restent à leur index: l'ordre
+// d'entrée est conservé. Le moteur utilisé est celui de sudoku_set_engine().
+//
+// Format texte: une grille par ligne, 81 caractères '1'-'9' et '0' ou '.'
+// pour les cases vides. Les lignes vides et celles commençant par '#' sont
+// ignorées.
+
+typedef enum {
+    BATCH_SOLVED = 0,
+    BATCH_UNSOLVABLE,           // Indices contradictoires ou aucune solution
+    BATCH_INVALID               // Ligne mal formée
+} BatchStatus;
+
+typedef struct {
+    size_t total;               // Grilles lues
+    size_t solved;
+    size_t unsolvable;
+    size_t invalid;
+    double seconds;             // Durée totale (lecture, résolution, écriture)
+} BatchStats;
+
+// Convertit une ligne de 81 caractères en grille compacte
+// Returns: false si la longueur ou un caractère est invalide
+bool sudoku_parse_line(const char *line, size_t length, uint8_t cells[81]);
+
+// Écrit une grille compacte en 81 caractères ('.' pour les cases vides)
+void sudoku_format_cells(const uint8_t cells[81], char text[81]);
+
+// Résout count grilles en place (grids: count * 81 octets)
+// status: BATCH_INVALID en entrée pour les grilles à ignorer, sinon mis à
+//         BATCH_SOLVED ou BATCH_UNSOLVABLE
+// num_threads: <= 0 pour un thread par CPU
+void sudoku_solve_batch(uint8_t *grids, uint8_t *status, size_t count, int num_threads);
+
+// Lit des grilles sur in, écrit une ligne par grille sur out, dans l'ordre:
+// la solution, ou "unsolvable" / "invalid"
+// Returns: false en cas d'erreur d'allocation
+bool sudoku_solve_stream(FILE *in, FILE *out, int num_threads, BatchStats *stats);
+
+#endif // SUDOKU_BATCH_H
@@ -0,0 +1,382 @@
+#define _POSIX_C_SOURCE 200809L  // sysconf
+
+#include "sudoku_bitmask.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define ALL_DIGITS 0x1FFu
+
+// Cases de chaque unité: lignes, colonnes puis blocs
+static const uint8_t UNIT_CELLS[SUDOKU_UNIT_COUNT][9] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8},
+    { 9, 10, 11, 12, 13, 14, 15, 16, 17},
+    {18, 19, 20, 21, 22, 23, 24, 25, 26},
+    {27, 28, 29, 30, 31, 32, 33, 34, 35},
+    {36, 37, 38, 39, 40, 41, 42, 43, 44},
+    {45, 46, 47, 48, 49, 50, 51, 52, 53},
+    {54, 55, 56, 57, 58, 59, 60, 61, 62},
+    {63, 64, 65, 66, 67, 68, 69, 70, 71},
+    {72, 73, 74, 75, 76, 77, 78, 79, 80},
+    { 0,  9, 18, 27, 36, 45, 54, 63, 72},
+    { 1, 10, 19, 28, 37, 46, 55, 64, 73},
+    { 2, 11, 20, 29, 38, 47, 56, 65, 74},
+    { 3, 12, 21, 30, 39, 48, 57, 66, 75},
+    { 4, 13, 22, 31, 40, 49, 58, 67, 76},
+    { 5, 14, 23, 32, 41, 50, 59, 68, 77},
+    { 6, 15, 24, 33, 42, 51, 60, 69, 78},
+    { 7, 16, 25, 34, 43, 52, 61, 70, 79},
+    { 8, 17, 26, 35, 44, 53, 62, 71, 80},
+    { 0,  1,  2,  9, 10, 11, 18, 19, 20},
+    { 3,  4,  5, 12, 13, 14, 21, 22, 23},
+    { 6,  7,  8, 15, 16, 17, 24, 25, 26},
+    {27, 28, 29, 36, 37, 38, 45, 46, 47},
+    {30, 31, 32, 39, 40, 41, 48, 49, 50},
+    {33, 34, 35, 42, 43, 44, 51, 52, 53},
+    {54, 55, 56, 63, 64, 65, 72, 73, 74},
+    {57, 58, 59, 66, 67, 68, 75, 76, 77},
+    {60, 61, 62, 69, 70, 71, 78, 79, 80},
+};
+
+// Bloc de chaque case
+static const uint8_t CELL_BOX[81] = {
+    0, 0, 0, 1, 1, 1, 2, 2, 2,
+    0, 0, 0, 1, 1, 1, 2, 2, 2,
+    0, 0, 0, 1, 1, 1, 2, 2, 2,
+    3, 3, 3, 4, 4, 4, 5, 5, 5,
+    3, 3, 3, 4, 4, 4, 5, 5, 5,
+    3, 3, 3, 4, 4, 4, 5, 5, 5,
+    6, 6, 6, 7, 7, 7, 8, 8, 8,
+    6, 6, 6, 7, 7, 7, 8, 8, 8,
+    6, 6, 6, 7, 7, 7, 8, 8, 8,
+};
+
+static inline unsigned candidates(const BitmaskSolver *s, int cell) {
+    unsigned used = s->unit_used[cell / 9] | s->unit_used[9 + cell % 9] |
+                    s->unit_used[18 + CELL_BOX[cell]];
+    return ~used & ALL_DIGITS;
+}
+
+static inline void place(BitmaskSolver *s, int cell, unsigned bit) {
+    s->cells[cell] = (uint8_t)(__builtin_ctz(bit) + 1);
+    s->unit_used[cell / 9] |= bit;
+    s->unit_used[9 + cell % 9] |= bit;
+    s->unit_used[18 + CELL_BOX[cell]] |= bit;
+    s->trail[s->trail_len++] = (uint8_t)cell;
+}
+
+// Défait les placements jusqu'à la marque
+static inline void undo_to(BitmaskSolver *s, int mark) {
+    while (s->trail_len > mark) {
+        int cell = s->trail[--s->trail_len];
+        unsigned keep = ~(1u << (s->cells[cell] - 1));
+        s->unit_used[cell / 9] &= keep;
+        s->unit_used[9 + cell % 9] &= keep;
+        s->unit_used[18 + CELL_BOX[cell]] &= keep;
+        s->cells[cell] = 0;
+    }
+}
+
+// Singletons nus et cachés jusqu'au point fixe
+// Returns: false si une case ou un chiffre n'a plus aucune possibilité
+static bool propagate(BitmaskSolver *s) {
+    bool progress = true;
+    while (progress) {
+        progress = false;
+
+        // Singletons nus: une seule valeur possible
+        for (int cell = 0; cell < 81; cell++) {
+            if (s->cells[cell]) continue;
+            unsigned cand = candidates(s, cell);
+            if (cand == 0) return false;
+            if ((cand & (cand - 1)) == 0) {
+                place(s, cell, cand);
+                progress = true;
+            }
+        }
+
+        // Singletons cachés: chiffres présents dans exactement une case vide
+        for (int unit = 0; unit < SUDOKU_UNIT_COUNT; unit++) {
+            unsigned once = 0, twice = 0;
+            for (int k = 0; k < 9; k++) {
+                int cell = UNIT_CELLS[unit][k];
+                if (s->cells[cell]) continue;
+                unsigned cand = candidates(s, cell);
+                twice |= once & cand;
+                once |= cand;
+            }
+            if ((once | s->unit_used[unit]) != ALL_DIGITS) return false;
+
+            unsigned hidden = once & ~twice;
+            while (hidden) {
+                unsigned bit = hidden & -hidden;
+                hidden ^= bit;
+
+                // La case a pu être prise par un autre singleton de l'unité
+                int target = -1;
+                for (int k = 0; k < 9; k++) {
+                    int cell = UNIT_CELLS[unit][k];
+                    if (!s->cells[cell] && (candidates(s, cell) & bit)) {
+                        target = cell;
+                        break;
+                    }
+                }
+                if (target < 0) return false;
+                place(s, target, bit);
+                progress = true;
+            }
+        }
+    }
+    return true;
+}
+
+// MRV: case vide avec le moins de candidats (après propagation)
+// Returns: -1 si la grille est complète
+static int choose_cell(const BitmaskSolver *s) {
+    int best = -1;
+    int best_count = 10;
+    for (int cell = 0; cell < 81; cell++) {
+        if (s->cells[cell]) continue;
+        int n = __builtin_popcount(candidates(s, cell));
+        if (n < best_count) {
+            best = cell;
+            best_count = n;
+            if (n == 2) break;  // Minimum après propagation
+        }
+    }
+    return best;
+}
+
+static inline bool stop_requested(const BitmaskSolver *s) {
+    return s->stop && __atomic_load_n(s->stop, __ATOMIC_RELAXED);
+}
+
+static void search(BitmaskSolver *s, int max_solutions, int *count, uint8_t *solution) {
+    int mark = s->trail_len;
+    if (!propagate(s)) {
+        undo_to(s, mark);
+        return;
+    }
+
+    int best = choose_cell(s);
+    if (best < 0) {
+        if (*count == 0 && solution) memcpy(solution, s->cells, 81);
+        (*count)++;
+        undo_to(s, mark);
+        return;
+    }
+
+    unsigned cand = candidates(s, best);
+    while (cand && *count < max_solutions && !stop_requested(s)) {
+        unsigned bit = cand & -cand;
+        cand ^= bit;
+
+        int branch_mark = s->trail_len;
+        s->steps++;
+        place(s, best, bit);
+        search(s, max_solutions, count, solution);
+        undo_to(s, branch_mark);
+    }
+    undo_to(s, mark);
+}
+
+bool bitmask_solver_init(BitmaskSolver *solver, const uint8_t cells[81]) {
+    memset(solver, 0, sizeof(BitmaskSolver));
+
+    for (int cell = 0; cell < 81; cell++) {
+        uint8_t digit = cells[cell];
+        if (digit == 0) continue;
+        if (digit > 9) return false;
+
+        unsigned bit = 1u << (digit - 1);
+        if (!(candidates(solver, cell) & bit)) return false;  // Indice en conflit
+        place(solver, cell, bit);
+    }
+    return true;
+}
+
+bool bitmask_solver_allows(const BitmaskSolver *solver, int cell, int digit) {
+    if (digit < 1 || digit > 9) return false;
+    if (solver->cells[cell]) return solver->cells[cell] == digit;
+    return (candidates(solver, cell) >> (digit - 1)) & 1;
+}
+
+bool bitmask_solver_place(BitmaskSolver *solver, int cell, int digit) {
+    if (!bitmask_solver_allows(solver, cell, digit)) return false;
+    if (!solver->cells[cell]) place(solver, cell, 1u << (digit - 1));
+    return true;
+}
+
+bool bitmask_solver_propagate(BitmaskSolver *solver) {
+    return propagate(solver);
+}
+
+int bitmask_solver_search(BitmaskSolver *solver, int max_solutions, uint8_t solution[81]) {
+    int count = 0;
+    if (max_solutions < 1) return 0;
+    search(solver, max_solutions, &count, solution);
+    return count;
+}
+
+// ============================================================================
+// COMPTAGE PARALLÈLE
+// ============================================================================
+
+typedef struct {
+    const uint8_t *frontier;    // Sous-grilles, 81 octets chacune
+    int frontier_count;
+    int next;                   // Prochaine sous-grille à prendre (atomique)
+    int max_solutions;
+    int count;                  // Solutions trouvées (atomique)
+    int stop;                   // Total atteint: tous les threads s'arrêtent
+    int solution_taken;
+    uint8_t *solution;
+    uint64_t steps;
+} SharedCount;
+
+// Développe l'arbre en largeur jusqu'à au moins target sous-grilles. Les
+// solutions complètes rencontrées en chemin sont comptées directement.
+// Returns: sous-grilles (à libérer), NULL si allocation impossible
+static uint8_t* expand_frontier(const BitmaskSolver *root, int target, int max_solutions,
+                                int *frontier_count, int *count, uint8_t *solution,
+                                uint64_t *steps) {
+    uint8_t *level = (uint8_t*)malloc(81);
+    if (!level) return NULL;
+    memcpy(level, root->cells, 81);
+    int level_count = 1;
+
+    while (level_count > 0 && level_count < target && *count < max_solutions) {
+        uint8_t *next = (uint8_t*)malloc((size_t)level_count * 9 * 81);
+        if (!next) {
+            free(level);
+            return NULL;
+        }
+        int next_count = 0;
+
+        for (int n = 0; n < level_count && *count < max_solutions; n++) {
+            BitmaskSolver s;
+            if (!bitmask_solver_init(&s, level + n * 81) || !propagate(&s)) continue;
+
+            int best = choose_cell(&s);
+            if (best < 0) {
+                if (*count == 0 && solution) memcpy(solution, s.cells, 81);
+                (*count)++;
+                continue;
+            }
+
+            unsigned cand = candidates(&s, best);
+            while (cand) {
+                unsigned bit = cand & -cand;
+                cand ^= bit;
+                uint8_t *child = next + next_count++ * 81;
+                memcpy(child, s.cells, 81);
+                child[best] = (uint8_t)(__builtin_ctz(bit) + 1);
+                (*steps)++;
+            }
+        }
+
+        free(level);
+        level = next;
+        level_count = next_count;
+    }
+
+    *frontier_count = level_count;
+    return level;
+}
+
+static void* count_worker(void *arg) {
+    SharedCount *shared = (SharedCount*)arg;
+    uint8_t local_solution[81];
+
+    while (!__atomic_load_n(&shared->stop, __ATOMIC_RELAXED)) {
+        int i = __atomic_fetch_add(&shared->next, 1, __ATOMIC_RELAXED);
+        if (i >= shared->frontier_count) break;
+
+        int remaining = shared->max_solutions - __atomic_load_n(&shared->count, __ATOMIC_RELAXED);
+        if (remaining <= 0) break;
+
+        BitmaskSolver s;
+        if (!bitmask_solver_init(&s, shared->frontier + (size_t)i * 81)) continue;
+        s.stop = &shared->stop;
+
+        int found = bitmask_solver_search(&s, remaining, shared->solution ? local_solution : NULL);
+        __atomic_fetch_add(&shared->steps, s.steps, __ATOMIC_RELAXED);
+        if (found == 0) continue;
+
+        // Une seule solution recopiée, lue par l'appelant après pthread_join
+        if (shared->solution && !__atomic_exchange_n(&shared->solution_taken, 1, __ATOMIC_RELAXED)) {
+            memcpy(shared->solution, local_solution, 81);
+        }
+        if (__atomic_add_fetch(&shared->count, found, __ATOMIC_RELAXED) >= shared->max_solutions) {
+            __atomic_store_n(&shared->stop, 1, __ATOMIC_RELAXED);
+        }
+    }
+    return NULL;
+}
+
+int bitmask_count_solutions(const uint8_t cells[81], int max_solutions, int num_threads,
+                            uint8_t solution[81], uint64_t *steps) {
+    if (steps) *steps = 0;
+
+    BitmaskSolver root;
+    if (max_solutions < 1 || !bitmask_solver_init(&root, cells)) return 0;
+
+    if (num_threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = (cpus > 0) ? (int)cpus : 1;
+    }
+
+    // Grille dense, simple résolution ou un seul thread: recherche séquentielle
+    uint8_t *frontier = NULL;
+    int frontier_count = 0;
+    int count = 0;
+    uint64_t total_steps = 0;
+    if (max_solutions >= 2 && num_threads >= 2 && root.trail_len < BITMASK_PARALLEL_MAX_CLUES) {
+        frontier = expand_frontier(&root, 4 * num_threads, max_solutions,
+                                   &frontier_count, &count, solution, &total_steps);
+    }
+    if (!frontier) {
+        count = bitmask_solver_search(&root, max_solutions, solution);
+        if (steps) *steps = root.steps;
+        return count;
+    }
+
+    if (count < max_solutions && frontier_count > 0) {
+        SharedCount shared;
+        memset(&shared, 0, sizeof(shared));
+        shared.frontier = frontier;
+        shared.frontier_count = frontier_count;
+        shared.max_solutions = max_solutions;
+        shared.count = count;
+        shared.solution_taken = (count > 0);
+        shared.solution = solution;
+
+        pthread_t threads[num_threads];
+        int started = 0;
+        for (int t = 1; t < num_threads; t++) {
+            if (pthread_create(&threads[started], NULL, count_worker, &shared) == 0) started++;
+        }
+        count_worker(&shared);  // Le thread appelant participe
+        for (int t = 0; t < started; t++) {
+            pthread_join(threads[t], NULL);
+        }
+
+        count = shared.count;
+        total_steps += shared.steps;
+    }
+    free(frontier);
+
+    if (steps) *steps = total_steps;
+    return count < max_solutions ? count : max_solutions;
+}
+
+bool bitmask_solve(uint8_t cells[81], uint64_t *steps) {
+    BitmaskSolver solver;
+    if (steps) *steps = 0;
+    if (!bitmask_solver_init(&solver, cells)) return false;
+
+    int found = bitmask_solver_search(&solver, 1, cells);
+    if (steps) *steps = solver.steps;
+    return found == 1;
+}
@@ -0,0 +1,80 @@
+#ifndef SUDOKU_BITMASK_H
+#define SUDOKU_BITMASK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// MOTEUR DE RÉSOLUTION PAR MASQUES DE BITS
+// ============================================================================
+//
+// Grille compacte de 81 octets, ligne par ligne (0 = vide, 1-9 = chiffre).
+// Chaque unité (9 lignes, 9 colonnes, 9 blocs) garde le masque des chiffres
+// déjà placés (bit d-1): les candidats d'une case valent
+// ~(ligne | colonne | bloc) & 0x1FF, le choix MRV se fait par popcount et
+// l'énumération des candidats par ctz.
+// Chaque placement est suivi d'une propagation des singletons nus (une seule
+// valeur possible) et cachés (un chiffre n'a plus qu'une place dans une
+// unité). Les placements sont empilés (trail) et défaits en dépilant, sans
+// recopier ni rebalayer la grille.
+
+#define SUDOKU_UNIT_COUNT 27
+
+// En dessous de ce nombre d'indices, bitmask_count_solutions() répartit
+// l'arbre de recherche sur plusieurs threads
+#define BITMASK_PARALLEL_MAX_CLUES 30
+
+typedef struct {
+    uint8_t cells[81];
+    uint16_t unit_used[SUDOKU_UNIT_COUNT];  // Lignes 0-8, colonnes 9-17, blocs 18-26
+    uint8_t trail[81];                      // Cases placées, dans l'ordre
+    int trail_len;
+    uint64_t steps;                         // Candidats essayés aux branchements
+    const int *stop;                        // Arrêt demandé ailleurs (NULL: jamais)
+} BitmaskSolver;
+
+// Initialise depuis une grille compacte
+// Returns: false si une valeur sort de 0-9 ou si deux indices se contredisent
+bool bitmask_solver_init(BitmaskSolver *solver, const uint8_t cells[81]);
+
+// Vrai si digit peut occuper la case: elle le contient déjà, ou elle est vide
+// et aucune case de sa ligne, colonne ou bloc ne le contient
+bool bitmask_solver_allows(const BitmaskSolver *solver, int cell, int digit);
+
+// Place digit dans la case, sans propagation (sans effet si elle le contient
+// déjà)
+// Returns: false si bitmask_solver_allows() le refuse
+bool bitmask_solver_place(BitmaskSolver *solver, int cell, int digit);
+
+// Place les singletons nus et cachés jusqu'au point fixe (les placements
+// restent dans la grille)
+// Returns: false si une case ou un chiffre n'a plus aucune possibilité (la
+//          grille n'a alors aucune solution)
+bool bitmask_solver_propagate(BitmaskSolver *solver);
+
+// Cherche jusqu'à max_solutions solutions (arrêt dès que ce nombre est atteint)
+// solution: reçoit la première solution trouvée (peut être NULL)
+// Returns: nombre de solutions trouvées (<= max_solutions)
+// La grille du solveur est restaurée dans son état initial au retour.
+int bitmask_solver_search(BitmaskSolver *solver, int max_solutions, uint8_t solution[81]);
+
+// Compte les solutions jusqu'à max_solutions (arrêt anticipé: 2 suffit pour
+// tester l'unicité). Pour une grille clairsemée (moins de
+// BITMASK_PARALLEL_MAX_CLUES indices) et max_solutions >= 2, les premiers
+// niveaux de l'arbre sont développés en largeur puis les sous-grilles sont
+// réparties entre num_threads threads, qui s'arrêtent tous dès que le total
+// atteint max_solutions.
+// num_threads: <= 0 pour un thread par CPU
+// solution: reçoit une solution trouvée (peut être NULL; en parallèle ce
+//           n'est pas forcément la première dans l'ordre séquentiel)
+// steps: reçoit le nombre de candidats essayés (peut être NULL)
+// Returns: nombre de solutions (<= max_solutions), 0 si indices contradictoires
+int bitmask_count_solutions(const uint8_t cells[81], int max_solutions, int num_threads,
+                            uint8_t solution[81], uint64_t *steps);
+
+// Résout une grille compacte en place
+// steps: reçoit le nombre de candidats essayés (peut être NULL)
+// Returns: true si une solution existe (cells est alors complétée)
+bool bitmask_solve(uint8_t cells[81], uint64_t *steps);
+
+#endif // SUDOKU_BITMASK_H
@@ -0,0 +1,149 @@
+#include "sudoku_dlx.h"
+#include <string.h>
+
+#define ROOT 0
+#define FIRST_ROW_NODE (1 + DLX_COLUMNS)
+
+// Les 4 contraintes couvertes par le candidat (case, chiffre 0-8)
+static void candidate_columns(int cell, int digit, int columns[4]) {
+    int row = cell / 9;
+    int col = cell % 9;
+    int box = (row / 3) * 3 + col / 3;
+    columns[0] = 1 + cell;
+    columns[1] = 1 + 81 + row * 9 + digit;
+    columns[2] = 1 + 162 + col * 9 + digit;
+    columns[3] = 1 + 243 + box * 9 + digit;
+}
+
+static void cover(DlxSolver *s, int c) {
+    s->left[s->right[c]] = s->left[c];
+    s->right[s->left[c]] = s->right[c];
+    for (int i = s->down[c]; i != c; i = s->down[i]) {
+        for (int j = s->right[i]; j != i; j = s->right[j]) {
+            s->up[s->down[j]] = s->up[j];
+            s->down[s->up[j]] = s->down[j];
+            s->size[s->column[j]]--;
+        }
+    }
+}
+
+static void uncover(DlxSolver *s, int c) {
+    for (int i = s->up[c]; i != c; i = s->up[i]) {
+        for (int j = s->left[i]; j != i; j = s->left[j]) {
+            s->size[s->column[j]]++;
+            s->up[s->down[j]] = (int16_t)j;
+            s->down[s->up[j]] = (int16_t)j;
+        }
+    }
+    s->left[s->right[c]] = (int16_t)c;
+    s->right[s->left[c]] = (int16_t)c;
+}
+
+static void search(DlxSolver *s, int max_solutions, int *count, uint8_t *solution) {
+    if (s->right[ROOT] == ROOT) {
+        if (*count == 0 && solution) {
+            memcpy(solution, s->clues, 81);
+            for (int k = 0; k < s->depth; k++) {
+                solution[s->chosen[k] / 9] = (uint8_t)(s->chosen[k] % 9 + 1);
+            }
+        }
+        (*count)++;
+        return;
+    }
+
+    // Colonne la moins remplie (heuristique S de Knuth)
+    int best = s->right[ROOT];
+    for (int c = s->right[best]; c != ROOT; c = s->right[c]) {
+        if (s->size[c] < s->size[best]) best = c;
+    }
+    if (s->size[best] == 0) return;
+
+    cover(s, best);
+    for (int r = s->down[best]; r != best && *count < max_solutions; r = s->down[r]) {
+        s->steps++;
+        s->chosen[s->depth++] = s->candidate[r];
+        for (int j = s->right[r]; j != r; j = s->right[j]) cover(s, s->column[j]);
+
+        search(s, max_solutions, count, solution);
+
+        for (int j = s->left[r]; j != r; j = s->left[j]) uncover(s, s->column[j]);
+        s->depth--;
+    }
+    uncover(s, best);
+}
+
+bool dlx_solver_init(DlxSolver *solver, const uint8_t cells[81]) {
+    DlxSolver *s = solver;
+    s->depth = 0;
+    s->steps = 0;
+    memset(s->clues, 0, sizeof(s->clues));
+
+    // En-têtes: liste circulaire autour de la racine
+    for (int c = 0; c <= DLX_COLUMNS; c++) {
+        s->left[c] = (int16_t)(c == 0 ? DLX_COLUMNS : c - 1);
+        s->right[c] = (int16_t)(c == DLX_COLUMNS ? 0 : c + 1);
+        s->up[c] = (int16_t)c;
+        s->down[c] = (int16_t)c;
+        s->column[c] = (int16_t)c;
+        s->candidate[c] = -1;
+        s->size[c] = 0;
+    }
+
+    // Une ligne de 4 nœuds par candidat, ajoutée en bas de chaque colonne
+    for (int cand = 0; cand < DLX_ROWS; cand++) {
+        int columns[4];
+        candidate_columns(cand / 9, cand % 9, columns);
+
+        int base = FIRST_ROW_NODE + cand * 4;
+        for (int k = 0; k < 4; k++) {
+            int n = base + k;
+            int c = columns[k];
+            s->left[n] = (int16_t)(base + (k + 3) % 4);
+            s->right[n] = (int16_t)(base + (k + 1) % 4);
+            s->up[n] = s->up[c];
+            s->down[n] = (int16_t)c;
+            s->down[s->up[c]] = (int16_t)n;
+            s->up[c] = (int16_t)n;
+            s->column[n] = (int16_t)c;
+            s->candidate[n] = (int16_t)cand;
+            s->size[c]++;
+        }
+    }
+
+    // Indices: la ligne du candidat est retenue d'office
+    bool covered[1 + DLX_COLUMNS] = {false};
+    for (int cell = 0; cell < 81; cell++) {
+        uint8_t digit = cells[cell];
+        if (digit == 0) continue;
+        if (digit > 9) return false;
+
+        int columns[4];
+        candidate_columns(cell, digit - 1, columns);
+        for (int k = 0; k < 4; k++) {
+            if (covered[columns[k]]) return false;  // Indice en conflit
+        }
+        for (int k = 0; k < 4; k++) {
+            covered[columns[k]] = true;
+            cover(s, columns[k]);
+        }
+        s->clues[cell] = digit;
+    }
+    return true;
+}
+
+int dlx_solver_search(DlxSolver *solver, int max_solutions, uint8_t solution[81]) {
+    int count = 0;
+    if (max_solutions < 1) return 0;
+    search(solver, max_solutions, &count, solution);
+    return count;
+}
+
+bool dlx_solve(uint8_t cells[81], uint64_t *steps) {
+    DlxSolver solver;
+    if (steps) *steps = 0;
+    if (!dlx_solver_init(&solver, cells)) return false;
+
+    int found = dlx_solver_search(&solver, 1, cells);
+    if (steps) *steps = solver.steps;
+    return found == 1;
+}
@@ -0,0 +1,49 @@
+#ifndef SUDOKU_DLX_H
+#define SUDOKU_DLX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ============================================================================
+// MOTEUR DANCING LINKS (ALGORITHME X DE KNUTH)
+// ============================================================================
+//
+// Le Sudoku est posé comme un problème de couverture exacte: 324 contraintes
+// (case remplie, chiffre par ligne, par colonne, par bloc) et 729 lignes
+// candidates (case, chiffre), chacune couvrant 4 contraintes. Les nœuds sont
+// des tableaux d'index préalloués dans DlxSolver: aucune allocation pendant
+// la recherche. Même grille compacte de 81 octets que sudoku_bitmask.h.
+
+#define DLX_COLUMNS 324
+#define DLX_ROWS    729
+#define DLX_NODES   (1 + DLX_COLUMNS + DLX_ROWS * 4)   // Racine + en-têtes + nœuds
+
+typedef struct {
+    int16_t left[DLX_NODES];
+    int16_t right[DLX_NODES];
+    int16_t up[DLX_NODES];
+    int16_t down[DLX_NODES];
+    int16_t column[DLX_NODES];      // En-tête de colonne de chaque nœud
+    int16_t candidate[DLX_NODES];   // case * 9 + (chiffre - 1)
+    int16_t size[1 + DLX_COLUMNS];  // Nœuds restants par colonne
+    int16_t chosen[81];             // Candidats choisis par la recherche
+    int depth;
+    uint8_t clues[81];
+    uint64_t steps;                 // Candidats essayés aux branchements
+} DlxSolver;
+
+// Construit la matrice et retire les indices
+// Returns: false si une valeur sort de 0-9 ou si deux indices se contredisent
+bool dlx_solver_init(DlxSolver *solver, const uint8_t cells[81]);
+
+// Cherche jusqu'à max_solutions solutions (arrêt dès que ce nombre est atteint)
+// solution: reçoit la première solution trouvée (peut être NULL)
+// Returns: nombre de solutions trouvées (<= max_solutions)
+int dlx_solver_search(DlxSolver *solver, int max_solutions, uint8_t solution[81]);
+
+// Résout une grille compacte en place
+// steps: reçoit le nombre de candidats essayés (peut être NULL)
+// Returns: true si une solution existe (cells est alors complétée)
+bool dlx_solve(uint8_t cells[81], uint64_t *steps);
+
+#endif // SUDOKU_DLX_H
@@ -0,0 +1,611 @@
+#include "sudoku_pipeline.h"
+#include "image_loader.h"
+#include "image_pyramid.h"
+#include "preprocessor.h"
+#include "grid_detector.h"
+#include "perspective.h"
+#include "cell_extractor.h"
+#include "cell_cleanup.h"
+#include "sudoku_solver.h"
+#include "simd_kernels.h"
+#include "clue_search.h"
+#include "image_composer.h"
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Seuils locaux: fenêtre d'environ 1/16 du petit côté (au moins 15 pixels),
+// de l'ordre d'une case, pour suivre les ombres sans effacer les traits
+#define ADAPTIVE_WINDOW_DIVISOR 16
+#define ADAPTIVE_MIN_WINDOW     15
+#define MEAN_C_OFFSET           10
+#define SAUVOLA_K               0.2f
+#define SAUVOLA_RANGE           128.0f
+
+// Demi-largeur de la recherche des bords autour du quadrilatère détecté
+// (plus le facteur de réduction de la détection)
+#define SUBPIXEL_BAND           3
+
+// Cases normalisées pour le CNN
+#define CELL_SIZE               28
+#define CELL_PIXELS             (CELL_SIZE * CELL_SIZE)
+
+// ============================================================================
+// ÉTAPES DU PIPELINE
+// ============================================================================
+
+// Copie les 81 cases nettoyées dans une mosaïque RGB à bordures rouges
+static void save_cells_debug_image(const GrayImage *cells) {
+    // Grid size: 9x9 cells of 28x28 with 1px borders: 9 * 28 + 10 * 1 = 262
+    int border = 1;
+    int cell_size = CELL_SIZE;
+    int grid_img_size = 9 * cell_size + 10 * border;
+
+    RGBImage *cells_grid = rgb_image_create(grid_img_size, grid_img_size, 3);
+    if (!cells_grid) return;
+
+    // Fill with red (borders)
+    for(int i=0; i<grid_img_size * grid_img_size * 3; i+=3) {
+        cells_grid->data[i] = 255;   // R
+        cells_grid->data[i+1] = 0;   // G
+        cells_grid->data[i+2] = 0;   // B
+    }
+
+    for (int i = 0; i < 81; i++) {
+        int start_y = border + (i / 9) * (cell_size + border);
+        int start_x = border + (i % 9) * (cell_size + border);
+
+        for (int y = 0; y < cell_size; y++) {
+            for (int x = 0; x < cell_size; x++) {
+                int dest_idx = ((start_y + y) * grid_img_size + (start_x + x)) * 3;
+                uint8_t val = cells[i].data[y * cell_size + x];
+                cells_grid->data[dest_idx] = val;
+                cells_grid->data[dest_idx+1] = val;
+                cells_grid->data[dest_idx+2] = val;
+            }
+        }
+    }
+    save_rgb_image("debug_6_cells.png", cells_grid);
+    rgb_image_free(cells_grid);
+}
+
+// Debug: grille détectée tracée sur l'image binaire
+static void save_grid_debug_image(const GrayImage *binary, const Quad *grid_quad) {
+    RGBImage *debug_grid = rgb_image_create(binary->width, binary->height, 3);
+    if (!debug_grid) return;
+
+    for (size_t i = 0; i < binary->width * binary->height; i++) {
+        uint8_t val = binary->data[i];
+        debug_grid->data[i*3] = val;
+        debug_grid->data[i*3+1] = val;
+        debug_grid->data[i*3+2] = val;
+    }
+
+    for (int i = 0; i < 4; i++) {
+        draw_line_rgb(debug_grid, grid_quad->corners[i], grid_quad->corners[(i+1)%4], 0, 255, 0, 3);
+    }
+    save_rgb_image("debug_4_grid_detected.png", debug_grid);
+    rgb_image_free(debug_grid);
+}
+
+// Fenêtre des seuils locaux pour une image de width x height
+static int adaptive_window(size_t width, size_t height) {
+    size_t min_side = (width < height) ? width : height;
+    int window = (int)(min_side / ADAPTIVE_WINDOW_DIVISOR) | 1;
+    return (window < ADAPTIVE_MIN_WINDOW) ? ADAPTIVE_MIN_WINDOW : window;
+}
+
+// Gris, binaire (traits blancs sur noir) et copie dilatée pour la détection
+// otsu_out: seuil d'Otsu retenu, -1 en seuils locaux
+static PipelineStatus preprocess_image(const RGBImage *image, const PipelineOptions *options,
+                                       GrayImage **gray_out, GrayImage **binary_out,
+                                       GrayImage **dilated_out, int *otsu_out) {
+    GrayImage *gray;
+    GrayImage *binary;
+    GrayImage *binary_dilated;
+    uint64_t t;
+    *otsu_out = -1;
+    if (options->threshold == PIPELINE_THRESHOLD_OTSU) {
+        // Gray, blur, Otsu (lines white on black) and the dilated copy for grid
+        // detection (connects broken lines), fused in two row-strip passes
+        PreprocessedImages pre;
+        t = trace_begin();
+        bool ok = preprocess_fused(image, 5, 1.0f, 3, options->save_debug_images, &pre);
+        trace_end(TRACE_PREPROCESS, t);
+        if (!ok) return PIPELINE_ERR_MEMORY;
+        if (options->save_debug_images) {
+            save_gray_image("debug_1_gray.png", pre.gray);
+            save_gray_image("debug_2_blurred.png", pre.blurred);
+        }
+        gray = pre.gray;
+        binary = pre.binary;
+        binary_dilated = pre.dilated;
+        *otsu_out = pre.threshold;
+        gray_image_free(pre.blurred);
+    } else {
+        t = trace_begin();
+        gray = rgb_to_gray(image);
+        trace_end(TRACE_GRAY, t);
+        if (!gray) return PIPELINE_ERR_MEMORY;
+        if (options->save_debug_images) save_gray_image("debug_1_gray.png", gray);
+
+        // Local threshold straight on the gray image (shadows, uneven lighting)
+        int window = adaptive_window(gray->width, gray->height);
+
+        t = trace_begin();
+        binary = gray_image_clone(gray);
+        bool ok = binary != NULL;
+        if (ok && options->threshold == PIPELINE_THRESHOLD_SAUVOLA) {
+            ok = threshold_sauvola(binary, window, SAUVOLA_K, SAUVOLA_RANGE);
+        } else if (ok) {
+            ok = threshold_mean_c(binary, window, MEAN_C_OFFSET);
+        }
+        if (ok) invert_image(binary);
+        trace_end(TRACE_THRESHOLD, t);
+        if (!ok) {
+            gray_image_free(binary);
+            gray_image_free(gray);
+            return PIPELINE_ERR_MEMORY;
+        }
+
+        // Create a dilated copy for grid detection (connects broken lines)
+        t = trace_begin();
+        binary_dilated = gray_image_clone(binary);
+        if (!binary_dilated) {
+            gray_image_free(binary);
+            gray_image_free(gray);
+            return PIPELINE_ERR_MEMORY;
+        }
+        dilate_binary(binary_dilated, 3);
+        trace_end(TRACE_DILATE, t);
+    }
+    if (options->save_debug_images) save_gray_image("debug_3_binary.png", binary_dilated);
+
+    *gray_out = gray;
+    *binary_out = binary;
+    *dilated_out = binary_dilated;
+    return PIPELINE_OK;
+}
+
+// Binarise la grille redressée depuis le gris pleine résolution, traits
+// blancs sur noir: seuil d'Otsu de toute l'image réduite (otsu >= 0), sinon
+// seuil local à l'échelle de la grille redressée
+static bool binarize_rectified(GrayImage *rectified, const PipelineOptions *options, int otsu) {
+    bool ok = true;
+    if (otsu >= 0) {
+        threshold_binary(rectified, (uint8_t)otsu);
+    } else {
+        int window = adaptive_window(rectified->width, rectified->height);
+        if (options->threshold == PIPELINE_THRESHOLD_SAUVOLA) {
+            ok = threshold_sauvola(rectified, window, SAUVOLA_K, SAUVOLA_RANGE);
+        } else {
+            ok = threshold_mean_c(rectified, window, MEAN_C_OFFSET);
+        }
+    }
+    if (ok) invert_image(rectified);
+    return ok;
+}
+
+// Prétraitement + détection + redressement + extraction des 81 cases
+// Les grandes photos sont détectées sur une copie réduite (pyramide): seuls le
+// recalage des coins (droites des bords) et le redressement lisent la pleine
+// résolution
+// gray_out: image en niveaux de gris conservée pour la composition finale
+// cell_pixels: 81 cases de CELL_SIZE x CELL_SIZE rangées bout à bout
+// cells: vues sur cell_pixels (données non possédées)
+static PipelineStatus extract_cells(const RGBImage *image, const PipelineOptions *options,
+                                    GrayImage **gray_out, Quad *grid_quad,
+                                    uint8_t *cell_pixels, GrayImage *cells) {
+    bool verbose = options->verbose;
+    uint64_t t;
+
+    // 1. Preprocessing, on a reduced copy of large photos
+    if (verbose) printf("Preprocessing...\n");
+    int factor = pyramid_detect_factor(image->width, image->height);
+    RGBImage *reduced = NULL;
+    if (factor > 1) {
+        t = trace_begin();
+        reduced = rgb_downsample_area(image, factor);
+        trace_end(TRACE_PYRAMID, t);
+        if (!reduced) return PIPELINE_ERR_MEMORY;
+        if (verbose) printf("Detecting on a %zux%zu copy (factor %d)...\n",
+                            reduced->width, reduced->height, factor);
+    }
+
+    GrayImage *gray;
+    GrayImage *binary;
+    GrayImage *binary_dilated;
+    int otsu;
+    PipelineStatus status = preprocess_image(reduced ? reduced : image, options,
+                                             &gray, &binary, &binary_dilated, &otsu);
+    rgb_image_free(reduced);
+    if (status != PIPELINE_OK) return status;
+
+    // 2. Grid Detection
+    if (verbose) printf("Detecting grid...\n");
+    t = trace_begin();
+    bool found = find_largest_quad(binary_dilated, grid_quad);
+    trace_end(TRACE_FIND_QUAD, t);
+    gray_image_free(binary_dilated);
+    if (!found) {
+        gray_image_free(binary);
+        gray_image_free(gray);
+        return PIPELINE_ERR_GRID;
+    }
+    if (verbose) printf("Grid detected!\n");
+
+    if (options->save_debug_images) save_grid_debug_image(binary, grid_quad);
+
+    // Full resolution from here on for reduced photos: the gray image is the
+    // warp input, corners mapped back then snapped to the ink
+    GrayImage *warp_source = binary;
+    if (factor > 1) {
+        gray_image_free(binary);
+        gray_image_free(gray);
+        binary = NULL;
+
+        t = trace_begin();
+        gray = rgb_to_gray(image);
+        trace_end(TRACE_GRAY, t);
+        if (!gray) return PIPELINE_ERR_MEMORY;
+        warp_source = gray;
+    }
+
+    // Subpixel corners from the border lines fitted on the full resolution
+    // gray image (kept as found if the fit fails)
+    t = trace_begin();
+    if (factor > 1) {
+        for (int i = 0; i < 4; i++) {
+            grid_quad->corners[i] = pyramid_map_point(grid_quad->corners[i], factor);
+        }
+        refine_quad_corners(gray, grid_quad, 2 * factor);
+    }
+    refine_quad_subpixel(gray, grid_quad, SUBPIXEL_BAND + factor);
+    trace_end(TRACE_REFINE_CORNERS, t);
+
+    // 3. Perspective Transform
+    if (verbose) printf("Rectifying grid...\n");
+
+    Quad dst_quad;
+    int size = 252; // 28 * 9
+    dst_quad.corners[0] = (Point2D){0, 0};
+    dst_quad.corners[1] = (Point2D){size, 0};
+    dst_quad.corners[2] = (Point2D){size, size};
+    dst_quad.corners[3] = (Point2D){0, size};
+
+    t = trace_begin();
+    HomographyMatrix H = compute_homography(grid_quad, &dst_quad);
+    // Warp the binary image to get clean, thresholded cells; the full
+    // resolution gray image is thresholded once rectified
+    GrayImage *rectified = warp_perspective(warp_source, &H, size, size);
+    bool ok = rectified && (factor == 1 || binarize_rectified(rectified, options, otsu));
+    trace_end(TRACE_WARP, t);
+    gray_image_free(binary);
+    if (!ok) {
+        gray_image_free(rectified);
+        gray_image_free(gray);
+        return PIPELINE_ERR_MEMORY;
+    }
+    if (options->save_debug_images) save_gray_image("debug_5_rectified.png", rectified);
+
+    // 4. Cell Extraction
+    if (verbose) printf("Extracting cells...\n");
+    t = trace_begin();
+    GrayImage *extracted[81] = {0};
+    ok = extract_sudoku_cells(rectified, extracted);
+    gray_image_free(rectified);
+
+    // Gather the cells into one contiguous buffer for the batched cleanup
+    for (int i = 0; i < 81; i++) {
+        ok = ok && extracted[i] && extracted[i]->width == CELL_SIZE && extracted[i]->height == CELL_SIZE;
+        if (ok) memcpy(cell_pixels + i * CELL_PIXELS, extracted[i]->data, CELL_PIXELS);
+        gray_image_free(extracted[i]);
+        cells[i] = (GrayImage){cell_pixels + i * CELL_PIXELS, CELL_SIZE, CELL_SIZE};
+    }
+    trace_end(TRACE_EXTRACT_CELLS, t);
+    if (!ok) {
+        gray_image_free(gray);
+        return PIPELINE_ERR_CELLS;
+    }
+
+    // Cells are already white on black (warped from the inverted binary image):
+    // only the border remnants are removed (keep the largest component)
+    if (verbose) printf("Inverting cells and creating debug image...\n");
+    t = trace_begin();
+    cell_cleanup_batch(cell_pixels, 81, CELL_SIZE, CELL_SIZE);
+    trace_end(TRACE_CELL_CLEANUP, t);
+    if (options->save_debug_images) save_cells_debug_image(cells);
+
+    *gray_out = gray;
+    return PIPELINE_OK;
+}
+
+// Reconnaissance CNN par lot + tri des candidats par probabilité
+static PipelineStatus recognize_cells(const CNNModel *model, InferenceContext *ctx,
+                                      const GrayImage *cells, bool verbose,
+                                      ClueCell *cell_candidates) {
+    // Pack all non-empty cells into a single NCHW batch so the CNN weights
+    // are streamed once per layer instead of once per cell
+    uint64_t t = trace_begin();
+    bool cell_empty[81];
+    int batch_slot[81];
+    int batch_count = 0;
+    float *batch_inputs = (float*)malloc(81 * 28 * 28 * sizeof(float));
+    float *batch_probs = (float*)malloc(81 * 10 * sizeof(float));
+    if (!batch_inputs || !batch_probs) {
+        free(batch_inputs);
+        free(batch_probs);
+        return PIPELINE_ERR_MEMORY;
+    }
+
+    for (int i = 0; i < 81; i++) {
+        cell_empty[i] = is_cell_empty(&cells[i]);
+        batch_slot[i] = -1;
+
+        if (!cell_empty[i]) {
+            float *input = prepare_cell_for_cnn(&cells[i]);
+            if (!input) {
+                free(batch_inputs);
+                free(batch_probs);
+                return PIPELINE_ERR_MEMORY;
+            }
+            memcpy(batch_inputs + batch_count * 28 * 28, input, 28 * 28 * sizeof(float));
+            free(input);
+            batch_slot[i] = batch_count++;
+        }
+    }
+
+    bool ok = cnn_forward_ctx(model, ctx, batch_inputs, batch_count, batch_probs);
+    free(batch_inputs);
+    trace_end(TRACE_CNN, t);
+    trace_count(TRACE_CELLS_CLASSIFIED, (uint64_t)batch_count);
+    if (!ok) {
+        free(batch_probs);
+        return PIPELINE_ERR_CNN;
+    }
+
+    if (verbose) {
+        printf("\n=== Raw Predictions ===\n");
+        printf("Row | Col | Empty? | Top 1 (Prob)| Top 2 (Prob)| Top 3 (Prob)\n");
+        printf("----|-----|--------|-------------|-------------|-------------\n");
+    }
+
+    for (int i = 0; i < 81; i++) {
+        cell_candidates[i].count = 0;
+
+        int r = i / 9;
+        int c = i % 9;
+
+        if (cell_empty[i]) {
+            if (verbose) printf("  %d |  %d  |  YES   |      -      |      -      |      -\n", r, c);
+            continue;
+        }
+
+        const float *probs = batch_probs + batch_slot[i] * 10;
+
+        // Store candidates: only 1-9 are valid for Sudoku
+        for(int d=1; d<=9; d++) {
+            cell_candidates[i].candidates[cell_candidates[i].count].digit = d;
+            cell_candidates[i].candidates[cell_candidates[i].count].prob = probs[d];
+            cell_candidates[i].count++;
+        }
+
+        // Sort candidates by probability (descending)
+        clue_cell_sort(&cell_candidates[i]);
+
+        if (verbose) {
+            printf("  %d |  %d  |   NO   |  %d (%5.1f%%) |  %d (%5.1f%%) |  %d (%5.1f%%)\n",
+                   r, c,
+                   cell_candidates[i].candidates[0].digit, cell_candidates[i].candidates[0].prob * 100,
+                   cell_candidates[i].candidates[1].digit, cell_candidates[i].candidates[1].prob * 100,
+                   cell_candidates[i].candidates[2].digit, cell_candidates[i].candidates[2].prob * 100);
+        }
+    }
+    free(batch_probs);
+    if (verbose) printf("=======================\n\n");
+
+    return PIPELINE_OK;
+}
+
+static void print_detected_grid(const SudokuGrid *s_grid) {
+    printf("Detected Grid (Corrected):\n");
+    for (int r = 0; r < 9; r++) {
+        if (r % 3 == 0) printf("+-------+-------+-------+\n");
+        for (int c = 0; c < 9; c++) {
+            if (c % 3 == 0) printf("| ");
+            // The fixed cells of the solved grid are the clues
+            if (s_grid->fixed[r][c])
+                printf("%d ", s_grid->grid[r][c]);
+            else
+                printf(". ");
+        }
+        printf("|\n");
+    }
+    printf("+-------+-------+-------+\n");
+}
+
+// ============================================================================
+// API
+// ============================================================================
+
+PipelineOptions pipeline_default_options(void) {
+    PipelineOptions options;
+    options.verbose = false;
+    options.save_debug_images = false;
+    options.compose_output = true;
+    options.threshold = PIPELINE_THRESHOLD_OTSU;
+    return options;
+}
+
+const char* pipeline_threshold_name(PipelineThreshold threshold) {
+    switch (threshold) {
+        case PIPELINE_THRESHOLD_OTSU:    return "otsu";
+        case PIPELINE_THRESHOLD_MEAN_C:  return "mean-c";
+        case PIPELINE_THRESHOLD_SAUVOLA: return "sauvola";
+    }
+    return "unknown";
+}
+
+bool pipeline_threshold_from_name(const char *name, PipelineThreshold *threshold) {
+    if (strcmp(name, "otsu") == 0) *threshold = PIPELINE_THRESHOLD_OTSU;
+    else if (strcmp(name, "mean-c") == 0) *threshold = PIPELINE_THRESHOLD_MEAN_C;
+    else if (strcmp(name, "sauvola") == 0) *threshold = PIPELINE_THRESHOLD_SAUVOLA;
+    else return false;
+    return true;
+}
+
+bool pipeline_configure_engines_from_env(void) {
+    bool ok = true;
+
+    const char *conv_algo = getenv("CNN_CONV_ALGO");
+    if (conv_algo) {
+        if (strcmp(conv_algo, "direct") == 0) cnn_set_conv_algorithm(CONV_ALGO_DIRECT);
+        else if (strcmp(conv_algo, "im2col") == 0) cnn_set_conv_algorithm(CONV_ALGO_IM2COL);
+        else {
+            LOG_ERROR("Convolution inconnue: %s (direct|im2col)", conv_algo);
+            ok = false;
+        }
+    }
+
+    const char *simd = getenv("CNN_SIMD");
+    if (simd) {
+        if (strcmp(simd, "scalar") == 0) simd_select_level(SIMD_LEVEL_SCALAR);
+        else if (strcmp(simd, "sse2") == 0) simd_select_level(SIMD_LEVEL_SSE2);
+        else if (strcmp(simd, "avx2") == 0) simd_select_level(SIMD_LEVEL_AVX2);
+        else if (strcmp(simd, "avx512") == 0) simd_select_level(SIMD_LEVEL_AVX512);
+        else {
+            LOG_ERROR("Niveau SIMD inconnu: %s (scalar|sse2|avx2|avx512)", simd);
+            ok = false;
+        }
+    }
+
+    const char *engine_name = getenv("SUDOKU_ENGINE");
+    SolverEngine engine;
+    if (engine_name && sudoku_engine_from_name(engine_name, &engine)) {
+        sudoku_set_engine(engine);
+    } else if (engine_name) {
+        LOG_ERROR("Moteur inconnu: %s (bitmask|dlx|backtrack)", engine_name);
+        ok = false;
+    }
+    return ok;
+}
+
+const char* pipeline_status_message(PipelineStatus status) {
+    switch (status) {
+        case PIPELINE_OK:             return "OK";
+        case PIPELINE_ERR_IMAGE:      return "Failed to load image";
+        case PIPELINE_ERR_GRID:       return "Failed to detect grid";
+        case PIPELINE_ERR_CELLS:      return "Failed to extract cells";
+        case PIPELINE_ERR_CNN:        return "CNN inference failed";
+        case PIPELINE_ERR_UNSOLVABLE: return "Could not find a valid grid configuration.";
+        case PIPELINE_ERR_MEMORY:     return "Out of memory";
+    }
+    return "Unknown error";
+}
+
+void pipeline_result_free(PipelineResult *result) {
+    if (!result) return;
+    rgb_image_free(result->output);
+    result->output = NULL;
+}
+
+static PipelineStatus run_pipeline(const CNNModel *model, InferenceContext *ctx,
+                                   const RGBImage *image, const PipelineOptions *options,
+                                   PipelineResult *result) {
+    if (!image || !image->data) return PIPELINE_ERR_IMAGE;
+
+    PipelineOptions defaults = pipeline_default_options();
+    if (!options) options = &defaults;
+    bool verbose = options->verbose;
+
+    memset(result, 0, sizeof(PipelineResult));
+
+    GrayImage *gray = NULL;
+    uint8_t *cell_pixels = (uint8_t*)malloc(81 * CELL_PIXELS);
+    GrayImage cells[81];
+    Quad grid_quad;
+    if (!cell_pixels) return PIPELINE_ERR_MEMORY;
+
+    PipelineStatus status = extract_cells(image, options, &gray, &grid_quad, cell_pixels, cells);
+    if (status != PIPELINE_OK) {
+        free(cell_pixels);
+        return status;
+    }
+
+    // 5. CNN Recognition
+    if (verbose) printf("Recognizing digits...\n");
+
+    InferenceContext *own_ctx = NULL;
+    if (!ctx) {
+        ctx = own_ctx = create_inference_context(model, 81);
+    }
+
+    ClueCell cell_candidates[81];
+    status = ctx ? recognize_cells(model, ctx, cells, verbose, cell_candidates)
+                 : PIPELINE_ERR_MEMORY;
+
+    free_inference_context(own_ctx);
+    free(cell_pixels);
+    if (status != PIPELINE_OK) {
+        gray_image_free(gray);
+        return status;
+    }
+
+    // Most probable consistent and solvable clue assignment
+    if (verbose) printf("Searching for the most probable valid grid configuration (branch and bound on joint probability)...\n");
+    ClueSearchResult search;
+    uint64_t t = trace_begin();
+    bool clues_found = clue_search_run(cell_candidates, &search);
+    trace_end(TRACE_CLUES, t);
+    trace_count(TRACE_CLUE_STEPS, (uint64_t)search.nodes);
+    if (!clues_found) {
+        gray_image_free(gray);
+        return PIPELINE_ERR_UNSOLVABLE;
+    }
+
+    // Initial clues (fixed cells) and solution
+    SudokuGrid s_grid;
+    SudokuGrid initial_s_grid;
+    for(int i=0; i<81; i++) {
+        int r = i / 9;
+        int c = i % 9;
+        bool fixed = search.clues[i] != 0;
+        s_grid.grid[r][c] = search.solution[i];
+        s_grid.fixed[r][c] = fixed;
+        initial_s_grid.grid[r][c] = search.clues[i];
+        initial_s_grid.fixed[r][c] = fixed;
+        result->clues[i] = search.clues[i];
+        result->solution[i] = search.solution[i];
+    }
+    if (verbose) {
+        printf("Valid grid found and solved! (log-probability %.3f%s, %d nodes, %d solver calls)\n",
+               search.log_prob, search.optimal ? "" : ", node limit reached",
+               search.nodes, search.solver_calls);
+        print_detected_grid(&s_grid);
+        printf("Sudoku Solved!\n");
+    }
+
+    // 7. Reconstruct Image
+    if (options->compose_output) {
+        if (verbose) printf("Composing output...\n");
+        t = trace_begin();
+        result->output = compose_solved_image(gray, &initial_s_grid, &s_grid, &grid_quad);
+        trace_end(TRACE_COMPOSE, t);
+    }
+
+    gray_image_free(gray);
+    return PIPELINE_OK;
+}
+
+PipelineStatus sudoku_pipeline_run(const CNNModel *model, InferenceContext *ctx,
+                                   const RGBImage *image, const PipelineOptions *options,
+                                   PipelineResult *result) {
+    uint64_t t = trace_begin();
+    PipelineStatus status = run_pipeline(model, ctx, image, options, result);
+    trace_end(TRACE_PIPELINE, t);
+
+    trace_count(TRACE_PIPELINE_RUNS, 1);
+    if (status != PIPELINE_OK) trace_count(TRACE_PIPELINE_ERRORS, 1);
+    return status;
+}
@@ -0,0 +1,78 @@
+#ifndef SUDOKU_PIPELINE_H
+#define SUDOKU_PIPELINE_H
+
+#include "utils.h"
+#include "cnn_model.h"
+
+// ============================================================================
+// PIPELINE COMPLET: IMAGE -> GRILLE RECONNUE -> SOLUTION
+// ============================================================================
+//
+// Enchaîne prétraitement, détection de grille, redressement, extraction des
+// cases, reconnaissance CNN, correction probabiliste des indices et
+// résolution. Réentrant: aucun état global, toutes les images intermédiaires
+// sont libérées, de sorte que le même modèle peut servir plusieurs appels
+// successifs (CLI, démon) ou concurrents (un InferenceContext par thread).
+
+typedef enum {
+    PIPELINE_OK = 0,
+    PIPELINE_ERR_IMAGE,         // Image absente ou illisible
+    PIPELINE_ERR_GRID,          // Grille non détectée
+    PIPELINE_ERR_CELLS,         // Extraction des cases impossible
+    PIPELINE_ERR_CNN,           // Échec de l'inférence
+    PIPELINE_ERR_UNSOLVABLE,    // Aucune configuration d'indices valide
+    PIPELINE_ERR_MEMORY         // Allocation impossible
+} PipelineStatus;
+
+// Binarisation avant la détection de grille
+typedef enum {
+    PIPELINE_THRESHOLD_OTSU,    // Flou gaussien 5x5 puis seuil global d'Otsu
+    PIPELINE_THRESHOLD_MEAN_C,  // Seuil local moyenne - C, une passe sans flou
+    PIPELINE_THRESHOLD_SAUVOLA  // Seuil local de Sauvola, une passe sans flou
+} PipelineThreshold;
+
+typedef struct {
+    bool verbose;               // Progression et prédictions brutes sur stdout
+    bool save_debug_images;     // Écrit debug_1_gray.png ... debug_6_cells.png
+    bool compose_output;        // Produit l'image de la grille résolue
+    PipelineThreshold threshold;
+} PipelineOptions;
+
+typedef struct {
+    int clues[81];              // Indices reconnus (après correction), 0 = vide
+    int solution[81];           // Grille résolue
+    RGBImage *output;           // Image composée (si compose_output) ou NULL
+} PipelineResult;
+
+// Options par défaut: silencieux, sans fichiers de debug, avec image de
+// sortie, binarisation d'Otsu
+PipelineOptions pipeline_default_options(void);
+
+// Nom court ("otsu", "mean-c", "sauvola") et conversion inverse
+// Returns: false si le nom est inconnu
+const char* pipeline_threshold_name(PipelineThreshold threshold);
+bool pipeline_threshold_from_name(const char *name, PipelineThreshold *threshold);
+
+// Exécute le pipeline sur une image RGB
+// ctx: contexte d'inférence de l'appelant (max_batch 81 conseillé), ou NULL
+//      pour en créer un temporaire
+// result: rempli si PIPELINE_OK; libérer avec pipeline_result_free()
+PipelineStatus sudoku_pipeline_run(const CNNModel *model, InferenceContext *ctx,
+                                   const RGBImage *image, const PipelineOptions *options,
+                                   PipelineResult *result);
+
+// Libère l'image de sortie d'un résultat
+void pipeline_result_free(PipelineResult *result);
+
+// Message d'erreur lisible
+const char* pipeline_status_message(PipelineStatus status);
+
+// Réglages de comparaison lus dans l'environnement (CLI, benchmark, démon):
+//   CNN_CONV_ALGO   convolution: direct ou im2col
+//   CNN_SIMD        plafond des noyaux choisis par cpuid: scalar, sse2, avx2, avx512
+//   SUDOKU_ENGINE   moteur de résolution: bitmask, dlx, backtrack
+// À appeler avant de démarrer des threads
+// Returns: false si une valeur est inconnue (signalée, réglage inchangé)
+bool pipeline_configure_engines_from_env(void);
+
+#endif // SUDOKU_PIPELINE_H
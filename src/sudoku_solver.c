@@ -1,5 +1,8 @@
 #include "sudoku_solver.h"
 #include "utils.h"
+#include "trace.h"
+#include "sudoku_bitmask.h"
+#include "sudoku_dlx.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -74,129 +77,177 @@ bool is_grid_complete(const SudokuGrid *grid) {
 }
 
 // ============================================================================
-// RÉSOLUTION BACKTRACKING SIMPLE
+// MOTEURS DE RÉSOLUTION (GRILLE COMPACTE)
 // ============================================================================
 
-static bool solve_backtrack(SudokuGrid *grid, int pos) {
+static SolverEngine solver_engine = SOLVER_ENGINE_BITMASK;
+
+void sudoku_set_engine(SolverEngine engine) {
+    solver_engine = engine;
+}
+
+SolverEngine sudoku_get_engine(void) {
+    return solver_engine;
+}
+
+const char* sudoku_engine_name(SolverEngine engine) {
+    switch (engine) {
+        case SOLVER_ENGINE_BACKTRACK: return "backtrack";
+        case SOLVER_ENGINE_BITMASK:   return "bitmask";
+        case SOLVER_ENGINE_DLX:       return "dlx";
+    }
+    return "unknown";
+}
+
+bool sudoku_engine_from_name(const char *name, SolverEngine *engine) {
+    if (strcmp(name, "backtrack") == 0) *engine = SOLVER_ENGINE_BACKTRACK;
+    else if (strcmp(name, "bitmask") == 0) *engine = SOLVER_ENGINE_BITMASK;
+    else if (strcmp(name, "dlx") == 0) *engine = SOLVER_ENGINE_DLX;
+    else return false;
+    return true;
+}
+
+// Backtracking de référence: cases dans l'ordre, chiffres de 1 à 9,
+// vérification par balayage de la ligne, de la colonne et du bloc
+static bool cell_accepts(const uint8_t *cells, int cell, int digit) {
+    int row = cell / 9;
+    int col = cell % 9;
+    int block = (row / 3) * 27 + (col / 3) * 3;
+    for (int k = 0; k < 9; k++) {
+        int r = row * 9 + k;
+        int c = k * 9 + col;
+        int b = block + (k / 3) * 9 + k % 3;
+        if ((r != cell && cells[r] == digit) || (c != cell && cells[c] == digit) ||
+            (b != cell && cells[b] == digit)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+typedef struct {
+    uint8_t cells[81];
+    int max_solutions;
+    int count;
+    uint8_t *solution;
+    uint64_t steps;
+} BacktrackSearch;
+
+static void backtrack_count(BacktrackSearch *search, int pos) {
+    while (pos < 81 && search->cells[pos] != 0) pos++;
+
     if (pos == 81) {
-        return true;  // Grille complète
+        if (search->count == 0 && search->solution) memcpy(search->solution, search->cells, 81);
+        search->count++;
+        return;
     }
-    
-    int row = pos / 9;
-    int col = pos % 9;
-    
-    // Si la case est déjà remplie (fixée), passer à la suivante
-    if (grid->fixed[row][col]) {
-        return solve_backtrack(grid, pos + 1);
+
+    for (int digit = 1; digit <= 9 && search->count < search->max_solutions; digit++) {
+        if (cell_accepts(search->cells, pos, digit)) {
+            search->steps++;
+            search->cells[pos] = (uint8_t)digit;
+            backtrack_count(search, pos + 1);
+            search->cells[pos] = 0;
+        }
     }
-    
-    // Essayer tous les chiffres de 1 à 9
-    for (int num = 1; num <= 9; num++) {
-        if (is_valid_placement(grid, row, col, num)) {
-            grid->grid[row][col] = num;
-            
-            if (solve_backtrack(grid, pos + 1)) {
-                return true;
+}
+
+static int backtrack_count_solutions(const uint8_t cells[81], int max_solutions,
+                                     uint8_t solution[81], uint64_t *steps) {
+    BacktrackSearch search;
+    memcpy(search.cells, cells, 81);
+    search.max_solutions = max_solutions;
+    search.count = 0;
+    search.solution = solution;
+    search.steps = 0;
+
+    for (int cell = 0; cell < 81; cell++) {
+        uint8_t digit = cells[cell];
+        if (digit > 9 || (digit != 0 && !cell_accepts(cells, cell, digit))) return 0;
+    }
+
+    if (max_solutions > 0) backtrack_count(&search, 0);
+    *steps = search.steps;
+    return search.count;
+}
+
+int sudoku_count_cells(const uint8_t cells[81], int max_solutions,
+                       uint8_t solution[81], uint64_t *steps) {
+    uint64_t engine_steps = 0;
+    int count = 0;
+
+    switch (solver_engine) {
+        case SOLVER_ENGINE_BACKTRACK:
+            count = backtrack_count_solutions(cells, max_solutions, solution, &engine_steps);
+            break;
+        case SOLVER_ENGINE_BITMASK: {
+            // Parallèle sur les grilles clairsemées quand max_solutions >= 2
+            count = bitmask_count_solutions(cells, max_solutions, 0, solution, &engine_steps);
+            break;
+        }
+        case SOLVER_ENGINE_DLX: {
+            DlxSolver solver;
+            if (dlx_solver_init(&solver, cells)) {
+                count = dlx_solver_search(&solver, max_solutions, solution);
+                engine_steps = solver.steps;
             }
-            
-            // Backtrack
-            grid->grid[row][col] = 0;
+            break;
         }
     }
-    
-    return false;
+
+    if (steps) *steps = engine_steps;
+    return count;
 }
 
-bool solve_sudoku(SudokuGrid *grid) {
-    LOG_INFO("Résolution de la grille Sudoku...");
-    bool solved = solve_backtrack(grid, 0);
-    
-    if (solved) {
-        LOG_INFO("Grille résolue avec succès!");
-    } else {
-        LOG_ERROR("Aucune solution trouvée");
-    }
-    
-    return solved;
+bool sudoku_solve_cells(uint8_t cells[81], uint64_t *steps) {
+    return sudoku_count_cells(cells, 1, cells, steps) == 1;
 }
 
 // ============================================================================
-// RÉSOLUTION OPTIMISÉE (MRV - Minimum Remaining Values)
+// RÉSOLUTION
 // ============================================================================
 
-// Compte les valeurs possibles pour une case
-static int count_possibilities(const SudokuGrid *grid, int row, int col) {
-    if (grid->fixed[row][col]) return 0;
-    
-    int count = 0;
-    for (int num = 1; num <= 9; num++) {
-        if (is_valid_placement(grid, row, col, num)) {
-            count++;
-        }
+// Valeurs hors 0-9 remplacées par 10, que tous les moteurs rejettent
+static void grid_to_cells(const SudokuGrid *grid, uint8_t cells[81]) {
+    for (int i = 0; i < 81; i++) {
+        int value = grid->grid[i / 9][i % 9];
+        cells[i] = (value >= 0 && value <= 9) ? (uint8_t)value : 10;
     }
-    return count;
 }
 
-// Trouve la case vide avec le moins de possibilités (MRV heuristic)
-static bool find_best_cell(const SudokuGrid *grid, int *best_row, int *best_col) {
-    int min_possibilities = 10;
-    bool found = false;
-    
-    for (int row = 0; row < 9; row++) {
-        for (int col = 0; col < 9; col++) {
-            if (grid->grid[row][col] == 0) {
-                int poss = count_possibilities(grid, row, col);
-                
-                if (poss == 0) {
-                    // Impasse détectée tôt
-                    return false;
-                }
-                
-                if (poss < min_possibilities) {
-                    min_possibilities = poss;
-                    *best_row = row;
-                    *best_col = col;
-                    found = true;
-                    
-                    // Optimisation: si seulement 1 possibilité, on prend immédiatement
-                    if (poss == 1) return true;
-                }
-            }
+// Résout via la grille compacte du moteur courant, puis recopie la solution
+static bool solve_with_engine(SudokuGrid *grid) {
+    uint8_t cells[81];
+    grid_to_cells(grid, cells);
+
+    uint64_t steps = 0;
+    bool solved = sudoku_solve_cells(cells, &steps);
+    trace_count(TRACE_SOLVER_STEPS, steps);
+
+    if (solved) {
+        for (int i = 0; i < 81; i++) {
+            grid->grid[i / 9][i % 9] = cells[i];
         }
     }
-    
-    return found;
+    return solved;
 }
 
-static bool solve_mrv_recursive(SudokuGrid *grid) {
-    int row, col;
-    
-    // Trouver la meilleure case à remplir (MRV)
-    if (!find_best_cell(grid, &row, &col)) {
-        // Soit grille complète, soit impasse
-        return is_grid_complete(grid);
-    }
+bool solve_sudoku(SudokuGrid *grid) {
+    LOG_INFO("Résolution de la grille Sudoku...");
+    bool solved = solve_with_engine(grid);
     
-    // Essayer tous les chiffres valides
-    for (int num = 1; num <= 9; num++) {
-        if (is_valid_placement(grid, row, col, num)) {
-            grid->grid[row][col] = num;
-            
-            if (solve_mrv_recursive(grid)) {
-                return true;
-            }
-            
-            // Backtrack
-            grid->grid[row][col] = 0;
-        }
+    if (solved) {
+        LOG_INFO("Grille résolue avec succès!");
+    } else {
+        LOG_ERROR("Aucune solution trouvée");
     }
     
-    return false;
+    return solved;
 }
 
 bool solve_sudoku_mrv(SudokuGrid *grid) {
     LOG_INFO("Résolution de la grille Sudoku (MRV optimisé)...");
-    bool solved = solve_mrv_recursive(grid);
+    bool solved = solve_with_engine(grid);
     
     if (solved) {
         LOG_INFO("Grille résolue avec succès (MRV)!");
@@ -211,48 +262,16 @@ bool solve_sudoku_mrv(SudokuGrid *grid) {
 // UNICITÉ DE SOLUTION
 // ============================================================================
 
-static int count_solutions_recursive(SudokuGrid *grid, int pos, int max_count, int *current_count) {
-    if (*current_count >= max_count) return *current_count;
-    
-    if (pos == 81) {
-        (*current_count)++;
-        return *current_count;
-    }
-    
-    int row = pos / 9;
-    int col = pos % 9;
-    
-    if (grid->fixed[row][col] || grid->grid[row][col] != 0) {
-        return count_solutions_recursive(grid, pos + 1, max_count, current_count);
-    }
-    
-    for (int num = 1; num <= 9; num++) {
-        if (is_valid_placement(grid, row, col, num)) {
-            grid->grid[row][col] = num;
-            count_solutions_recursive(grid, pos + 1, max_count, current_count);
-            grid->grid[row][col] = 0;
-            
-            if (*current_count >= max_count) break;
-        }
-    }
-    
-    return *current_count;
-}
-
 int count_solutions(SudokuGrid *grid, int max_solutions) {
-    int count = 0;
-    count_solutions_recursive(grid, 0, max_solutions, &count);
-    return count;
+    uint8_t cells[81];
+    grid_to_cells(grid, cells);
+    return sudoku_count_cells(cells, max_solutions, NULL, NULL);
 }
 
 bool has_unique_solution(const SudokuGrid *grid) {
-    SudokuGrid *test_grid = create_sudoku_grid();
-    memcpy(test_grid, grid, sizeof(SudokuGrid));
-    
-    int num_solutions = count_solutions(test_grid, 2);
-    
-    free_sudoku_grid(test_grid);
-    return num_solutions == 1;
+    uint8_t cells[81];
+    grid_to_cells(grid, cells);
+    return sudoku_count_cells(cells, 2, NULL, NULL) == 1;
 }
 
 // ============================================================================
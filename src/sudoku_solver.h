@@ -14,16 +14,51 @@ typedef struct {
     bool fixed[9][9];       // true si la case était dans la grille originale
 } SudokuGrid;
 
+// ============================================================================
+// MOTEURS DE RÉSOLUTION
+// ============================================================================
+
+// Moteur utilisé par toutes les fonctions de résolution et de comptage
+typedef enum {
+    SOLVER_ENGINE_BITMASK,      // Masques de bits + propagation (sudoku_bitmask.h)
+    SOLVER_ENGINE_DLX,          // Dancing Links, couverture exacte (sudoku_dlx.h)
+    SOLVER_ENGINE_BACKTRACK     // Backtracking naïf, cases dans l'ordre (référence)
+} SolverEngine;
+
+// Sélectionne le moteur (global, par défaut SOLVER_ENGINE_BITMASK); à régler
+// avant de lancer des threads. Tous les moteurs trouvent les mêmes grilles
+// solubles mais peuvent rendre des solutions différentes si plusieurs existent.
+void sudoku_set_engine(SolverEngine engine);
+SolverEngine sudoku_get_engine(void);
+
+// Nom court ("bitmask", "dlx", "backtrack") et conversion inverse
+// Returns: false si le nom est inconnu
+const char* sudoku_engine_name(SolverEngine engine);
+bool sudoku_engine_from_name(const char *name, SolverEngine *engine);
+
+// Compte les solutions d'une grille compacte (81 octets, 0 = vide), avec
+// arrêt dès max_solutions atteint
+// solution: reçoit la première solution trouvée (peut être NULL)
+// steps: reçoit le nombre de candidats essayés (peut être NULL)
+// Returns: 0 si des indices se contredisent
+int sudoku_count_cells(const uint8_t cells[81], int max_solutions,
+                       uint8_t solution[81], uint64_t *steps);
+
+// Résout une grille compacte en place. Returns: true si solution trouvée
+bool sudoku_solve_cells(uint8_t cells[81], uint64_t *steps);
+
 // ============================================================================
 // RÉSOLUTION
 // ============================================================================
 
-// Résout une grille de Sudoku par backtracking optimisé
-// grid: grille à résoudre (modifiée en place)
+// Résout une grille de Sudoku avec le moteur courant
+// grid: grille à résoudre (modifiée en place); les cases non nulles sont des
+//       indices, des indices contradictoires rendent la grille insoluble
 // Returns: true si solution trouvée, false sinon
 bool solve_sudoku(SudokuGrid *grid);
 
-// Résout avec heuristique MRV (Minimum Remaining Values)
+// Résout avec heuristique MRV (Minimum Remaining Values); même moteur que
+// solve_sudoku (les moteurs bitmask et DLX choisissent déjà la case par MRV)
 bool solve_sudoku_mrv(SudokuGrid *grid);
 
 // ============================================================================
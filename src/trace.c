@@ -0,0 +1,143 @@
+#define _POSIX_C_SOURCE 200809L  // clock_gettime
+
+#include "trace.h"
+#include <string.h>
+#include <time.h>
+
+// Agrégats globaux, mis à jour par builtins atomiques (ordre relâché: seules
+// les valeurs comptent, aucune synchronisation n'en dépend)
+static TraceStageStats stage_stats[TRACE_STAGE_COUNT];
+static uint64_t counter_values[TRACE_COUNTER_COUNT];
+
+static const char *STAGE_NAMES[TRACE_STAGE_COUNT] = {
+    "load", "pyramid", "gray", "threshold", "dilate", "preprocess", "find_quad",
+    "refine_corners", "warp", "extract_cells", "cell_cleanup", "cnn", "clues", "compose",
+    "pipeline"
+};
+
+static const char *COUNTER_NAMES[TRACE_COUNTER_COUNT] = {
+    "pipeline_runs", "pipeline_errors", "cells_classified", "clue_steps", "solver_steps"
+};
+
+uint64_t trace_begin(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+void trace_end(TraceStage stage, uint64_t start_ns) {
+    uint64_t elapsed = trace_begin() - start_ns;
+    TraceStageStats *stats = &stage_stats[stage];
+
+    __atomic_fetch_add(&stats->calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats->total_ns, elapsed, __ATOMIC_RELAXED);
+
+    uint64_t current = __atomic_load_n(&stats->max_ns, __ATOMIC_RELAXED);
+    while (elapsed > current &&
+           !__atomic_compare_exchange_n(&stats->max_ns, &current, elapsed, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+void trace_count(TraceCounter counter, uint64_t value) {
+    __atomic_fetch_add(&counter_values[counter], value, __ATOMIC_RELAXED);
+}
+
+void trace_snapshot(TraceSnapshot *out) {
+    for (int s = 0; s < TRACE_STAGE_COUNT; s++) {
+        out->stages[s].calls = __atomic_load_n(&stage_stats[s].calls, __ATOMIC_RELAXED);
+        out->stages[s].total_ns = __atomic_load_n(&stage_stats[s].total_ns, __ATOMIC_RELAXED);
+        out->stages[s].max_ns = __atomic_load_n(&stage_stats[s].max_ns, __ATOMIC_RELAXED);
+    }
+    for (int c = 0; c < TRACE_COUNTER_COUNT; c++) {
+        out->counters[c] = __atomic_load_n(&counter_values[c], __ATOMIC_RELAXED);
+    }
+}
+
+void trace_reset(void) {
+    for (int s = 0; s < TRACE_STAGE_COUNT; s++) {
+        __atomic_store_n(&stage_stats[s].calls, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stage_stats[s].total_ns, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&stage_stats[s].max_ns, 0, __ATOMIC_RELAXED);
+    }
+    for (int c = 0; c < TRACE_COUNTER_COUNT; c++) {
+        __atomic_store_n(&counter_values[c], 0, __ATOMIC_RELAXED);
+    }
+}
+
+const char* trace_stage_name(TraceStage stage) {
+    return (stage >= 0 && stage < TRACE_STAGE_COUNT) ? STAGE_NAMES[stage] : "unknown";
+}
+
+const char* trace_counter_name(TraceCounter counter) {
+    return (counter >= 0 && counter < TRACE_COUNTER_COUNT) ? COUNTER_NAMES[counter] : "unknown";
+}
+
+// ============================================================================
+// EXPORT
+// ============================================================================
+
+void trace_write_json(FILE *out) {
+    TraceSnapshot snap;
+    trace_snapshot(&snap);
+
+    fprintf(out, "{\n  \"stages\": {\n");
+    for (int s = 0; s < TRACE_STAGE_COUNT; s++) {
+        const TraceStageStats *st = &snap.stages[s];
+        double total_ms = st->total_ns / 1e6;
+        fprintf(out, "    \"%s\": {\"calls\": %llu, \"total_ms\": %.3f, \"mean_ms\": %.3f, \"max_ms\": %.3f}%s\n",
+                STAGE_NAMES[s], (unsigned long long)st->calls, total_ms,
+                st->calls ? total_ms / st->calls : 0.0, st->max_ns / 1e6,
+                (s + 1 < TRACE_STAGE_COUNT) ? "," : "");
+    }
+    fprintf(out, "  },\n  \"counters\": {\n");
+    for (int c = 0; c < TRACE_COUNTER_COUNT; c++) {
+        fprintf(out, "    \"%s\": %llu%s\n", COUNTER_NAMES[c],
+                (unsigned long long)snap.counters[c],
+                (c + 1 < TRACE_COUNTER_COUNT) ? "," : "");
+    }
+    fprintf(out, "  }\n}\n");
+}
+
+void trace_write_prometheus(FILE *out) {
+    TraceSnapshot snap;
+    trace_snapshot(&snap);
+
+    fprintf(out, "# HELP sudoku_stage_seconds_total Time spent in each pipeline stage.\n");
+    fprintf(out, "# TYPE sudoku_stage_seconds_total counter\n");
+    for (int s = 0; s < TRACE_STAGE_COUNT; s++) {
+        fprintf(out, "sudoku_stage_seconds_total{stage=\"%s\"} %.9f\n",
+                STAGE_NAMES[s], snap.stages[s].total_ns / 1e9);
+    }
+
+    fprintf(out, "# HELP sudoku_stage_calls_total Number of executions of each pipeline stage.\n");
+    fprintf(out, "# TYPE sudoku_stage_calls_total counter\n");
+    for (int s = 0; s < TRACE_STAGE_COUNT; s++) {
+        fprintf(out, "sudoku_stage_calls_total{stage=\"%s\"} %llu\n",
+                STAGE_NAMES[s], (unsigned long long)snap.stages[s].calls);
+    }
+
+    fprintf(out, "# HELP sudoku_stage_max_seconds Longest single execution of each pipeline stage.\n");
+    fprintf(out, "# TYPE sudoku_stage_max_seconds gauge\n");
+    for (int s = 0; s < TRACE_STAGE_COUNT; s++) {
+        fprintf(out, "sudoku_stage_max_seconds{stage=\"%s\"} %.9f\n",
+                STAGE_NAMES[s], snap.stages[s].max_ns / 1e9);
+    }
+
+    for (int c = 0; c < TRACE_COUNTER_COUNT; c++) {
+        fprintf(out, "# TYPE sudoku_%s_total counter\n", COUNTER_NAMES[c]);
+        fprintf(out, "sudoku_%s_total %llu\n", COUNTER_NAMES[c],
+                (unsigned long long)snap.counters[c]);
+    }
+}
+
+bool trace_write(FILE *out, const char *format) {
+    if (strcmp(format, "json") == 0) {
+        trace_write_json(out);
+    } else if (strcmp(format, "prometheus") == 0) {
+        trace_write_prometheus(out);
+    } else {
+        return false;
+    }
+    return true;
+}
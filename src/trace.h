@@ -0,0 +1,86 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// ============================================================================
+// TRACES: DURÉES PAR ÉTAPE ET COMPTEURS
+// ============================================================================
+//
+// Instrumentation toujours active et peu coûteuse: chaque étape du pipeline
+// est encadrée par trace_begin()/trace_end() (horloge monotone), les compteurs
+// sont incrémentés par trace_count(). Les agrégats sont globaux au processus
+// et mis à jour par opérations atomiques, donc utilisables depuis plusieurs
+// workers sans verrou. Export JSON ou format texte Prometheus.
+
+typedef enum {
+    TRACE_LOAD = 0,             // Décodage de l'image d'entrée
+    TRACE_PYRAMID,              // rgb_downsample_area (détection sur image réduite)
+    TRACE_GRAY,                 // rgb_to_gray (seuils locaux, pleine résolution après réduction)
+    TRACE_THRESHOLD,            // Seuil local + invert_image
+    TRACE_DILATE,               // dilate_binary (seuils locaux)
+    TRACE_PREPROCESS,           // preprocess_fused (gris, flou, Otsu, dilatation)
+    TRACE_FIND_QUAD,            // find_largest_quad
+    TRACE_REFINE_CORNERS,       // Coins ramenés, recalés et ajustés (droites des bords)
+    TRACE_WARP,                 // compute_homography + warp_perspective
+    TRACE_EXTRACT_CELLS,        // extract_sudoku_cells
+    TRACE_CELL_CLEANUP,         // Nettoyage des bordures des cases
+    TRACE_CNN,                  // Préparation du lot + inférence CNN
+    TRACE_CLUES,                // clue_search_run (résolution incluse)
+    TRACE_COMPOSE,              // compose_solved_image
+    TRACE_PIPELINE,             // sudoku_pipeline_run complet
+    TRACE_STAGE_COUNT
+} TraceStage;
+
+typedef enum {
+    TRACE_PIPELINE_RUNS = 0,    // Appels de sudoku_pipeline_run
+    TRACE_PIPELINE_ERRORS,      // Appels terminés en erreur
+    TRACE_CELLS_CLASSIFIED,     // Cases non vides passées au CNN
+    TRACE_CLUE_STEPS,           // Nœuds visités par la recherche d'indices
+    TRACE_SOLVER_STEPS,         // Chiffres essayés par le solveur (backtracking)
+    TRACE_COUNTER_COUNT
+} TraceCounter;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+} TraceStageStats;
+
+typedef struct {
+    TraceStageStats stages[TRACE_STAGE_COUNT];
+    uint64_t counters[TRACE_COUNTER_COUNT];
+} TraceSnapshot;
+
+// Horloge monotone en nanosecondes (début d'une mesure)
+uint64_t trace_begin(void);
+
+// Termine une mesure commencée par trace_begin()
+void trace_end(TraceStage stage, uint64_t start_ns);
+
+// Ajoute value à un compteur
+void trace_count(TraceCounter counter, uint64_t value);
+
+// Copie les agrégats courants
+void trace_snapshot(TraceSnapshot *out);
+
+// Remet tous les agrégats à zéro
+void trace_reset(void);
+
+// Nom court d'une étape / d'un compteur ("gray", "cells_classified", ...)
+const char* trace_stage_name(TraceStage stage);
+const char* trace_counter_name(TraceCounter counter);
+
+// Écrit les agrégats en JSON (durées en millisecondes)
+void trace_write_json(FILE *out);
+
+// Écrit les agrégats au format texte Prometheus (durées en secondes)
+void trace_write_prometheus(FILE *out);
+
+// Écrit selon le format demandé: "json" ou "prometheus"
+// Returns: false si le format est inconnu
+bool trace_write(FILE *out, const char *format);
+
+#endif // TRACE_H
@@ -1,4 +1,5 @@
 #include "utils.h"
+#include "simd_kernels.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
@@ -94,13 +95,44 @@ void matrix_multiply(const Matrix *a, const Matrix *b, Matrix *result) {
         return;
     }
     
-    for (size_t i = 0; i < a->rows; i++) {
-        for (size_t j = 0; j < b->cols; j++) {
-            float sum = 0.0f;
-            for (size_t k = 0; k < a->cols; k++) {
-                sum += a->data[i * a->cols + k] * b->data[k * b->cols + j];
+    gemm_blocked((int)a->rows, (int)b->cols, (int)a->cols,
+                 a->data, (int)a->cols,
+                 b->data, (int)b->cols,
+                 result->data, (int)result->cols, false);
+}
+
+// Tailles de blocs: un panneau GEMM_BLOCK_K x GEMM_BLOCK_N de B (64 Ko)
+// tient en L2, et une ligne de C de GEMM_BLOCK_N floats reste en L1
+#define GEMM_BLOCK_N 256
+#define GEMM_BLOCK_K 64
+
+void gemm_blocked(int m, int n, int k,
+                  const float *A, int lda,
+                  const float *B, int ldb,
+                  float *C, int ldc, bool accumulate) {
+    const SimdKernels *kernels = simd_kernels();
+    
+    if (!accumulate) {
+        for (int i = 0; i < m; i++) {
+            memset(C + (size_t)i * ldc, 0, n * sizeof(float));
+        }
+    }
+    
+    for (int jj = 0; jj < n; jj += GEMM_BLOCK_N) {
+        int j_end = min_int(jj + GEMM_BLOCK_N, n);
+        
+        for (int pp = 0; pp < k; pp += GEMM_BLOCK_K) {
+            int p_end = min_int(pp + GEMM_BLOCK_K, k);
+            
+            for (int i = 0; i < m; i++) {
+                const float *a_row = A + (size_t)i * lda;
+                float *c_row = C + (size_t)i * ldc;
+                
+                // Ordre i-k-j: la boucle interne est un axpy contigu sur C et B
+                for (int p = pp; p < p_end; p++) {
+                    kernels->axpy(a_row[p], B + (size_t)p * ldb + jj, c_row + jj, j_end - jj);
+                }
             }
-            result->data[i * result->cols + j] = sum;
         }
     }
 }
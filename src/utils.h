@@ -59,6 +59,14 @@ void matrix_elementwise_multiply(const Matrix *a, const Matrix *b, Matrix *resul
 void matrix_scale(Matrix *mat, float scalar);
 void matrix_transpose(const Matrix *src, Matrix *dst);
 
+// Produit matriciel bloqué (row-major): C = A * B, ou C += A * B si accumulate
+// A: (m x k, pas lda), B: (k x n, pas ldb), C: (m x n, pas ldc)
+// Les blocs de B sont parcourus de façon à rester en cache L1/L2.
+void gemm_blocked(int m, int n, int k,
+                  const float *A, int lda,
+                  const float *B, int ldb,
+                  float *C, int ldc, bool accumulate);
+
 // ============================================================================
 // GESTION MÉMOIRE IMAGES
 // ============================================================================
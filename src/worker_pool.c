@@ -0,0 +1,228 @@
+#define _GNU_SOURCE  // pthread_setaffinity_np, CPU_SET
+
+#include "worker_pool.h"
+#include "utils.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+typedef struct {
+    void *job;
+    double enqueue_ms;
+} QueueSlot;
+
+typedef struct {
+    WorkerPool *pool;
+    int id;
+    pthread_t thread;
+} Worker;
+
+struct WorkerPool {
+    WorkerPoolConfig config;
+    WorkerInitFn init;
+    WorkerFreeFn free_state;
+    WorkerHandleFn handle;
+    WorkerShedFn shed;
+    void *user_data;
+
+    // File circulaire protégée par mutex
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    QueueSlot *slots;
+    int head;
+    int count;
+    bool stopping;
+
+    WorkerPoolStats stats;
+
+    Worker *workers;
+    int started;
+};
+
+static double monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int worker_pool_cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (int)n : 1;
+}
+
+static void pin_current_thread(int worker_id) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(worker_id % worker_pool_cpu_count(), &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        LOG_ERROR("Affinité impossible pour le worker %d", worker_id);
+    }
+#else
+    (void)worker_id;
+#endif
+}
+
+// Retire le prochain travail (bloquant). Returns: false à l'arrêt, file vide
+static bool dequeue(WorkerPool *pool, QueueSlot *out) {
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->count == 0 && !pool->stopping) {
+        pthread_cond_wait(&pool->not_empty, &pool->mutex);
+    }
+    if (pool->count == 0) {
+        pthread_mutex_unlock(&pool->mutex);
+        return false;
+    }
+
+    *out = pool->slots[pool->head];
+    pool->head = (pool->head + 1) % pool->config.queue_capacity;
+    pool->count--;
+    pool->stats.queue_depth = pool->count;
+    pthread_mutex_unlock(&pool->mutex);
+    return true;
+}
+
+static void count_outcome(WorkerPool *pool, bool shed) {
+    pthread_mutex_lock(&pool->mutex);
+    if (shed) pool->stats.shed++;
+    else pool->stats.completed++;
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void* worker_main(void *arg) {
+    Worker *worker = (Worker*)arg;
+    WorkerPool *pool = worker->pool;
+
+    if (pool->config.pin_workers) pin_current_thread(worker->id);
+    void *state = pool->init ? pool->init(worker->id, pool->user_data) : NULL;
+
+    QueueSlot slot;
+    while (dequeue(pool, &slot)) {
+        double age = monotonic_ms() - slot.enqueue_ms;
+        bool too_old = pool->config.max_queue_age_ms > 0 && age > pool->config.max_queue_age_ms;
+
+        // Pendant l'arrêt, les travaux restants sont délestés plutôt que traités
+        bool stopping;
+        pthread_mutex_lock(&pool->mutex);
+        stopping = pool->stopping;
+        pthread_mutex_unlock(&pool->mutex);
+
+        if (too_old || stopping) {
+            pool->shed(slot.job, pool->user_data);
+            count_outcome(pool, true);
+        } else {
+            pool->handle(state, slot.job, pool->user_data);
+            count_outcome(pool, false);
+        }
+    }
+
+    if (pool->free_state) pool->free_state(state, pool->user_data);
+    return NULL;
+}
+
+WorkerPool* worker_pool_create(const WorkerPoolConfig *config,
+                               WorkerInitFn init, WorkerFreeFn free_state,
+                               WorkerHandleFn handle, WorkerShedFn shed,
+                               void *user_data) {
+    if (!config || config->num_workers < 1 || config->queue_capacity < 1 || !handle || !shed) {
+        LOG_ERROR("worker_pool_create: configuration invalide");
+        return NULL;
+    }
+
+    WorkerPool *pool = (WorkerPool*)calloc(1, sizeof(WorkerPool));
+    if (!pool) return NULL;
+
+    pool->config = *config;
+    pool->init = init;
+    pool->free_state = free_state;
+    pool->handle = handle;
+    pool->shed = shed;
+    pool->user_data = user_data;
+    pool->slots = (QueueSlot*)malloc(config->queue_capacity * sizeof(QueueSlot));
+    pool->workers = (Worker*)calloc(config->num_workers, sizeof(Worker));
+    if (!pool->slots || !pool->workers) {
+        free(pool->slots);
+        free(pool->workers);
+        free(pool);
+        return NULL;
+    }
+
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->not_empty, NULL);
+
+    for (int i = 0; i < config->num_workers; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].id = i;
+        if (pthread_create(&pool->workers[i].thread, NULL, worker_main, &pool->workers[i]) != 0) {
+            LOG_ERROR("Impossible de démarrer le worker %d", i);
+            worker_pool_destroy(pool);
+            return NULL;
+        }
+        pool->started++;
+    }
+
+    LOG_INFO("Pool de workers: %d threads, file %d, âge max %.0f ms%s",
+             config->num_workers, config->queue_capacity, config->max_queue_age_ms,
+             config->pin_workers ? ", affinité fixée" : "");
+    return pool;
+}
+
+bool worker_pool_submit(WorkerPool *pool, void *job) {
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->stopping || pool->count == pool->config.queue_capacity) {
+        pool->stats.rejected++;
+        pthread_mutex_unlock(&pool->mutex);
+        return false;
+    }
+
+    int tail = (pool->head + pool->count) % pool->config.queue_capacity;
+    pool->slots[tail].job = job;
+    pool->slots[tail].enqueue_ms = monotonic_ms();
+    pool->count++;
+    pool->stats.submitted++;
+    pool->stats.queue_depth = pool->count;
+
+    pthread_cond_signal(&pool->not_empty);
+    pthread_mutex_unlock(&pool->mutex);
+    return true;
+}
+
+WorkerPoolStats worker_pool_stats(WorkerPool *pool) {
+    pthread_mutex_lock(&pool->mutex);
+    WorkerPoolStats stats = pool->stats;
+    pthread_mutex_unlock(&pool->mutex);
+    return stats;
+}
+
+void worker_pool_destroy(WorkerPool *pool) {
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stopping = true;
+    pthread_cond_broadcast(&pool->not_empty);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < pool->started; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+
+    // Aucun worker démarré (échec de création): vider la file ici
+    QueueSlot slot;
+    while (pool->count > 0) {
+        slot = pool->slots[pool->head];
+        pool->head = (pool->head + 1) % pool->config.queue_capacity;
+        pool->count--;
+        pool->shed(slot.job, pool->user_data);
+    }
+
+    pthread_cond_destroy(&pool->not_empty);
+    pthread_mutex_destroy(&pool->mutex);
+    free(pool->slots);
+    free(pool->workers);
+    free(pool);
+}
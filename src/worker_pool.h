@@ -0,0 +1,75 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// ============================================================================
+// POOL DE WORKERS AVEC FILE BORNÉE ET CONTRÔLE D'ADMISSION
+// ============================================================================
+//
+// Un nombre fixe de threads consomme une file circulaire bornée (plusieurs
+// producteurs, plusieurs consommateurs). Chaque worker possède un état privé
+// créé dans son propre thread (ex: InferenceContext), après l'éventuelle
+// fixation d'affinité, afin que ses tampons soient alloués sur son nœud NUMA.
+//
+// Contrôle de charge:
+//   - admission: worker_pool_submit() refuse immédiatement un travail quand la
+//     file est pleine (pas de blocage du producteur)
+//   - délestage: un travail resté plus de max_queue_age_ms dans la file est
+//     remis au callback shed au lieu d'être traité (le client a probablement
+//     déjà abandonné; mieux vaut répondre "surchargé" tout de suite)
+
+typedef struct WorkerPool WorkerPool;
+
+typedef struct {
+    int num_workers;            // Nombre de threads (>= 1)
+    int queue_capacity;         // Profondeur maximale de la file (>= 1)
+    double max_queue_age_ms;    // Âge maximal au retrait (<= 0: illimité)
+    bool pin_workers;           // Worker i fixé sur le CPU i % nombre de CPU
+} WorkerPoolConfig;
+
+// Compteurs cumulés depuis la création
+typedef struct {
+    size_t submitted;           // Travaux acceptés dans la file
+    size_t rejected;            // Refusés à l'admission (file pleine)
+    size_t shed;                // Délestés (trop vieux ou arrêt du pool)
+    size_t completed;           // Traités par un worker
+    int queue_depth;            // Profondeur courante
+} WorkerPoolStats;
+
+// Crée l'état privé d'un worker (appelé dans le thread du worker)
+typedef void* (*WorkerInitFn)(int worker_id, void *user_data);
+
+// Libère l'état privé d'un worker (appelé dans le thread du worker)
+typedef void (*WorkerFreeFn)(void *worker_state, void *user_data);
+
+// Traite un travail
+typedef void (*WorkerHandleFn)(void *worker_state, void *job, void *user_data);
+
+// Reçoit un travail délesté (doit libérer le travail)
+typedef void (*WorkerShedFn)(void *job, void *user_data);
+
+// Démarre le pool
+// Returns: NULL si la configuration est invalide ou si un thread ne démarre pas
+WorkerPool* worker_pool_create(const WorkerPoolConfig *config,
+                               WorkerInitFn init, WorkerFreeFn free_state,
+                               WorkerHandleFn handle, WorkerShedFn shed,
+                               void *user_data);
+
+// Soumet un travail sans bloquer
+// Returns: false si la file est pleine ou le pool arrêté (le travail reste
+// à la charge de l'appelant)
+bool worker_pool_submit(WorkerPool *pool, void *job);
+
+// Lit les compteurs
+WorkerPoolStats worker_pool_stats(WorkerPool *pool);
+
+// Arrête le pool: les travaux en cours se terminent, ceux encore en file sont
+// délestés, puis les threads sont joints et leur état libéré
+void worker_pool_destroy(WorkerPool *pool);
+
+// Nombre de CPU en ligne (1 si indéterminé)
+int worker_pool_cpu_count(void);
+
+#endif // WORKER_POOL_H